@@ -22,12 +22,17 @@
  */
 
 #include <cstdlib>
+#include <cstring>
 #include <stdint.h>
 
 #if defined(ENABLE_SMART_SCREEN_SUPPORT)
 #include "SmartScreen/SmartScreen.h"
 #endif
 
+#include "SessionTracer.h"
+#include "FlightRecorder.h"
+#include "ThunderLogger.h"
+
 #include "AVS.h"
 
 WPEFramework::SmartScreen *AvsSmartScreen;
@@ -49,6 +54,35 @@ void AVS_DeInitialize()
 	
 }
 
+bool AVS_SetLogLevel(const char *tag, const char *level)
+{
+	if(level == NULL)
+	{
+		return false;
+	}
+
+	const alexaClientSDK::avsCommon::utils::logger::Level logLevel = alexaClientSDK::avsCommon::utils::logger::convertNameToLevel(level);
+	if(logLevel == alexaClientSDK::avsCommon::utils::logger::Level::UNKNOWN)
+	{
+		return false;
+	}
+
+	if(tag == NULL)
+	{
+		WPEFramework::ThunderLogger::SetLogLevel(logLevel);
+		return true;
+	}
+	return WPEFramework::ThunderLogger::SetTagLogLevel(tag, logLevel);
+}
+
+void AVS_ClearLogLevel(const char *tag)
+{
+	if(tag != NULL)
+	{
+		WPEFramework::ThunderLogger::ClearTagLogLevel(tag);
+	}
+}
+
 void Voice_Start()
 {
 	if(AvsSmartScreen)
@@ -67,11 +101,357 @@ void Voice_Stop()
 	
 }
 
+void Voice_Cancel()
+{
+	if(AvsSmartScreen)
+	{
+		AvsSmartScreen->Cancel();
+	}
+}
+
 void Voice_Data(const uint32_t seq,const uint8_t dataBuffer[], const uint16_t length)
+{
+	struct iovec frame;
+	frame.iov_base = const_cast<uint8_t *>(dataBuffer);
+	frame.iov_len  = length;
+	Voice_DataV(seq, &frame, 1);
+}
+
+uint32_t Voice_DataV(const uint32_t seq, const struct iovec *frames, const uint32_t count)
+{
+	if(AvsSmartScreen == NULL || frames == NULL || count == 0)
+	{
+		return 0;
+	}
+	return AvsSmartScreen->Data(seq, frames, count);
+}
+
+bool Voice_SetInputFormat(const uint32_t sample_rate_hz, const uint32_t channels)
+{
+	if(AvsSmartScreen == NULL)
+	{
+		return false;
+	}
+	return AvsSmartScreen->SetInputFormat(sample_rate_hz, channels);
+}
+
+bool Voice_SetInputCodec(const voice_codec_t codec)
+{
+	if(AvsSmartScreen == NULL)
+	{
+		return false;
+	}
+	switch(codec)
+	{
+		case VOICE_CODEC_PCM_16:    return AvsSmartScreen->SetInputCodec(WPEFramework::AudioDecoder::Codec::PCM_16);
+		case VOICE_CODEC_ADPCM_IMA: return AvsSmartScreen->SetInputCodec(WPEFramework::AudioDecoder::Codec::ADPCM_IMA);
+		case VOICE_CODEC_OPUS:      return AvsSmartScreen->SetInputCodec(WPEFramework::AudioDecoder::Codec::OPUS);
+	}
+	return false;
+}
+
+bool Voice_SetKeyword(const uint32_t sample_begin, const uint32_t sample_end)
+{
+	if(AvsSmartScreen == NULL)
+	{
+		return false;
+	}
+	return AvsSmartScreen->SetKeyword(sample_begin, sample_end);
+}
+
+bool Voice_GetQueueStats(voice_queue_stats_t *stats)
+{
+	WPEFramework::AudioStagingQueue::Stats queueStats;
+
+	if(stats == NULL || AvsSmartScreen == NULL || !AvsSmartScreen->GetQueueStats(queueStats))
+	{
+		return false;
+	}
+
+	stats->capacity         = queueStats.capacity;
+	stats->depth            = queueStats.depth;
+	stats->high_water_mark  = queueStats.highWaterMark;
+	stats->frames_enqueued  = queueStats.enqueued;
+	stats->frames_dropped   = queueStats.dropped;
+	stats->frames_committed = queueStats.committed;
+	stats->latency_us_min   = queueStats.latencyUsMin;
+	stats->latency_us_avg   = queueStats.latencyUsAvg;
+	stats->latency_us_max   = queueStats.latencyUsMax;
+	return true;
+}
+
+bool Voice_GetJitterStats(voice_jitter_stats_t *stats)
+{
+	WPEFramework::AudioJitterBuffer::Stats jitterStats;
+
+	if(stats == NULL || AvsSmartScreen == NULL || !AvsSmartScreen->GetJitterStats(jitterStats))
+	{
+		return false;
+	}
+
+	stats->target_delay_ms      = jitterStats.targetDelayMs;
+	stats->jitter_ms            = jitterStats.jitterMs;
+	stats->buffered_ms          = jitterStats.bufferedMs;
+	stats->added_latency_ms_avg = jitterStats.addedLatencyMsAvg;
+	stats->added_latency_ms_max = jitterStats.addedLatencyMsMax;
+	stats->underruns            = jitterStats.underruns;
+	stats->overflows            = jitterStats.overflows;
+	stats->frames_released      = jitterStats.framesReleased;
+	return true;
+}
+
+bool Voice_GetSequenceStats(voice_sequence_stats_t *stats)
+{
+	WPEFramework::AudioSequenceTracker::Stats sequenceStats;
+
+	if(stats == NULL || AvsSmartScreen == NULL || !AvsSmartScreen->GetSequenceStats(sequenceStats))
+	{
+		return false;
+	}
+
+	stats->frames_received  = sequenceStats.received;
+	stats->frames_lost      = sequenceStats.lost;
+	stats->frames_reordered = sequenceStats.reordered;
+	stats->frames_concealed = sequenceStats.concealed;
+	stats->frames_late      = sequenceStats.late;
+	return true;
+}
+
+bool Voice_GetEncoderStats(voice_encoder_stats_t *stats)
+{
+	WPEFramework::AudioEncoder::Stats encoderStats;
+
+	if(stats == NULL || AvsSmartScreen == NULL || !AvsSmartScreen->GetEncoderStats(encoderStats))
+	{
+		return false;
+	}
+
+	stats->frames_encoded = encoderStats.frames;
+	stats->bytes_in       = encoderStats.bytesIn;
+	stats->bytes_out      = encoderStats.bytesOut;
+	stats->encode_us      = encoderStats.encodeUs;
+	return true;
+}
+
+bool Voice_GetRecognizeStats(voice_recognize_stats_t *stats)
+{
+	WPEFramework::RecognizeController::Stats recognizeStats;
+
+	if(stats == NULL || AvsSmartScreen == NULL || !AvsSmartScreen->GetRecognizeStats(recognizeStats))
+	{
+		return false;
+	}
+
+	stats->starts       = recognizeStats.starts;
+	stats->stops        = recognizeStats.stops;
+	stats->cancels      = recognizeStats.cancels;
+	stats->preemptions  = recognizeStats.preemptions;
+	stats->ignored      = recognizeStats.ignored;
+	stats->idle_ms      = recognizeStats.idleMs;
+	stats->listening_ms = recognizeStats.listeningMs;
+	stats->expecting_ms = recognizeStats.expectingMs;
+	stats->thinking_ms  = recognizeStats.thinkingMs;
+	stats->speaking_ms  = recognizeStats.speakingMs;
+	return true;
+}
+
+void Voice_SetEndOfSpeechHandler(voice_end_of_speech_handler_t handler, void *user_data)
 {
 	if(AvsSmartScreen)
-	{	
-		AvsSmartScreen->Data(seq,dataBuffer,length);
+	{
+		AvsSmartScreen->SetEndOfSpeechHandler(handler, user_data);
 	}
-	
+}
+
+bool Voice_GetEndpointStats(voice_endpoint_stats_t *stats)
+{
+	WPEFramework::SmartScreen::EndpointStats endpointStats;
+
+	if(stats == NULL || AvsSmartScreen == NULL || !AvsSmartScreen->GetEndpointStats(endpointStats))
+	{
+		return false;
+	}
+
+	stats->speech_ms           = endpointStats.speechMs;
+	stats->end_of_speech_ms    = endpointStats.endOfSpeechMs;
+	stats->time_saved_ms       = endpointStats.savedMs;
+	stats->end_of_speech       = endpointStats.endOfSpeech;
+	stats->endpoints           = endpointStats.endpoints;
+	stats->time_saved_total_ms = endpointStats.savedMsTotal;
+	return true;
+}
+
+bool Voice_GetTrimStats(voice_trim_stats_t *stats)
+{
+	WPEFramework::AudioSilenceTrimmer::Stats trimStats;
+
+	if(stats == NULL || AvsSmartScreen == NULL || !AvsSmartScreen->GetTrimStats(trimStats))
+	{
+		return false;
+	}
+
+	stats->trimmed_ms       = trimStats.trimmedMs;
+	stats->onset            = trimStats.onset;
+	stats->sessions         = trimStats.sessions;
+	stats->trimmed_total_ms = trimStats.trimmedMsTotal;
+	return true;
+}
+
+bool Voice_GetNoiseSuppressorStats(voice_noise_suppressor_stats_t *stats)
+{
+	WPEFramework::AudioNoiseSuppressor::Stats suppressorStats;
+
+	if(stats == NULL || AvsSmartScreen == NULL || !AvsSmartScreen->GetNoiseSuppressorStats(suppressorStats))
+	{
+		return false;
+	}
+
+	stats->frames       = suppressorStats.frames;
+	stats->frame_us_avg = suppressorStats.frameUsAvg;
+	stats->frame_us_max = suppressorStats.frameUsMax;
+	stats->hop_ms       = suppressorStats.hopMs;
+	stats->bypassed     = suppressorStats.bypassed;
+	return true;
+}
+
+bool Voice_GetEchoCancellerStats(voice_echo_canceller_stats_t *stats)
+{
+	WPEFramework::AudioEchoCanceller::Stats cancellerStats;
+
+	if(stats == NULL || AvsSmartScreen == NULL || !AvsSmartScreen->GetEchoCancellerStats(cancellerStats))
+	{
+		return false;
+	}
+
+	stats->frames        = cancellerStats.frames;
+	stats->active_frames = cancellerStats.activeFrames;
+	stats->erle_db       = cancellerStats.erleDb;
+	stats->delay_ms      = cancellerStats.delayMs;
+	stats->delay_locked  = cancellerStats.delayLocked;
+	stats->frame_us_avg  = cancellerStats.frameUsAvg;
+	stats->frame_us_max  = cancellerStats.frameUsMax;
+	stats->block_ms      = cancellerStats.blockMs;
+	return true;
+}
+
+bool Voice_GetLevelStats(voice_level_stats_t *stats)
+{
+	WPEFramework::AudioLevelMeter::Stats levelStats;
+
+	if(stats == NULL || AvsSmartScreen == NULL || !AvsSmartScreen->GetLevelStats(levelStats))
+	{
+		return false;
+	}
+
+	stats->rms_dbfs              = levelStats.last.rmsDbfs;
+	stats->peak_dbfs             = levelStats.last.peakDbfs;
+	stats->clips                 = levelStats.last.clips;
+	stats->session_frames        = levelStats.frames;
+	stats->session_rms_dbfs_min  = levelStats.rmsDbfsMin;
+	stats->session_rms_dbfs_mean = levelStats.rmsDbfsMean;
+	stats->session_rms_dbfs_max  = levelStats.rmsDbfsMax;
+	stats->session_peak_dbfs     = levelStats.peakDbfs;
+	stats->session_clips         = levelStats.clips;
+	return true;
+}
+
+void Voice_SetStreamBeginTime(const uint64_t time_ns)
+{
+	if(AvsSmartScreen != NULL)
+	{
+		AvsSmartScreen->SetStreamBeginTime(time_ns);
+	}
+}
+
+bool Voice_GetLatencyStats(voice_latency_stats_t *stats)
+{
+	WPEFramework::SmartScreen::LatencyStats latencyStats;
+
+	if(stats == NULL || AvsSmartScreen == NULL || !AvsSmartScreen->GetLatencyStats(latencyStats))
+	{
+		return false;
+	}
+
+	stats->write_count    = latencyStats.captureToWrite.count;
+	stats->write_p50_us   = latencyStats.captureToWrite.p50Us;
+	stats->write_p95_us   = latencyStats.captureToWrite.p95Us;
+	stats->write_p99_us   = latencyStats.captureToWrite.p99Us;
+	stats->write_max_us   = latencyStats.captureToWrite.maxUs;
+	stats->upload_count   = latencyStats.captureToUpload.count;
+	stats->upload_p50_us  = latencyStats.captureToUpload.p50Us;
+	stats->upload_p95_us  = latencyStats.captureToUpload.p95Us;
+	stats->upload_p99_us  = latencyStats.captureToUpload.p99Us;
+	stats->upload_max_us  = latencyStats.captureToUpload.maxUs;
+	stats->upload_last_us = latencyStats.lastUploadUs;
+	return true;
+}
+
+bool Voice_GetDispatchStats(voice_dispatch_stats_t *stats)
+{
+	WPEFramework::DispatchQueue::Stats dispatchStats;
+
+	if(stats == NULL || AvsSmartScreen == NULL || !AvsSmartScreen->GetDispatchStats(dispatchStats))
+	{
+		return false;
+	}
+
+	stats->posted          = dispatchStats.posted;
+	stats->dispatched      = dispatchStats.dispatched;
+	stats->dropped         = dispatchStats.dropped;
+	stats->depth           = dispatchStats.depth;
+	stats->wait_us_avg     = dispatchStats.waitUsAvg;
+	stats->wait_us_max     = dispatchStats.waitUsMax;
+	stats->dispatch_us_avg = dispatchStats.dispatchUsAvg;
+	stats->dispatch_us_max = dispatchStats.dispatchUsMax;
+	return true;
+}
+
+void Voice_TraceEvent(const voice_trace_event_t event, const char *session_id, const uint64_t time_ns)
+{
+	std::shared_ptr<WPEFramework::SessionTracer> tracer = WPEFramework::SessionTracer::instance();
+
+	WPEFramework::FlightRecorder::instance()->Record(WPEFramework::FlightRecorder::Type::SESSION, static_cast<uint32_t>(event));
+
+	switch(event)
+	{
+		case VOICE_TRACE_SESSION_BEGIN: tracer->BeginSession(session_id != NULL ? session_id : "", time_ns); break;
+		case VOICE_TRACE_STREAM_BEGIN:  tracer->Trace(WPEFramework::SessionTracer::Event::STREAM_BEGIN, time_ns); break;
+		case VOICE_TRACE_STREAM_KWD:    tracer->Trace(WPEFramework::SessionTracer::Event::STREAM_KWD, time_ns); break;
+		case VOICE_TRACE_STREAM_END:    tracer->Trace(WPEFramework::SessionTracer::Event::STREAM_END, time_ns); break;
+		case VOICE_TRACE_SESSION_END:   tracer->Trace(WPEFramework::SessionTracer::Event::SESSION_END, time_ns); break;
+	}
+}
+
+bool Voice_GetSessionTrace(voice_session_trace_t *trace)
+{
+	WPEFramework::SessionTracer::Record record;
+
+	if(trace == NULL || !WPEFramework::SessionTracer::instance()->GetLastRecord(record))
+	{
+		return false;
+	}
+
+	strncpy(trace->session_id, record.sessionId, sizeof(trace->session_id) - 1);
+	trace->session_id[sizeof(trace->session_id) - 1] = '\0';
+	trace->first_write_ms     = record.phases.firstWriteMs;
+	trace->listen_ms          = record.phases.listenMs;
+	trace->end_to_think_ms    = record.phases.endToThinkMs;
+	trace->think_ms           = record.phases.thinkMs;
+	trace->speak_directive_ms = record.phases.speakDirectiveMs;
+	trace->first_audio_ms     = record.phases.firstAudioMs;
+	trace->total_ms           = record.phases.totalMs;
+	return true;
+}
+
+size_t Voice_ExportSessionTraces(char *buffer, const size_t size)
+{
+	const std::string json = WPEFramework::SessionTracer::instance()->ExportChromeTrace();
+
+	if(buffer != NULL && size > 0)
+	{
+		const size_t length = json.size() < size - 1 ? json.size() : size - 1;
+		memcpy(buffer, json.c_str(), length);
+		buffer[length] = '\0';
+	}
+	return json.size();
 }
@@ -23,16 +23,231 @@
 
 #pragma once
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/uio.h>
+
+/// Voice input codecs
+typedef enum {
+   VOICE_CODEC_PCM_16    = 0,   ///< Interleaved 16-bit little endian PCM
+   VOICE_CODEC_ADPCM_IMA = 1,   ///< IMA ADPCM blocks with a 4 byte predictor header, mono
+   VOICE_CODEC_OPUS      = 2    ///< One Opus packet per frame
+} voice_codec_t;
+
+/// Voice staging queue statistics
+typedef struct {
+   uint32_t capacity;          ///< Number of frame slots in the staging queue
+   uint32_t depth;             ///< Number of frame slots currently queued
+   uint32_t high_water_mark;   ///< Highest number of frame slots queued at once
+   uint64_t frames_enqueued;   ///< Frames accepted from the audio source
+   uint64_t frames_dropped;    ///< Frames dropped because the queue was full
+   uint64_t frames_committed;  ///< Frame slots written to the shared data stream
+   uint32_t latency_us_min;    ///< Minimum enqueue to commit latency in microseconds
+   uint32_t latency_us_avg;    ///< Average enqueue to commit latency in microseconds
+   uint32_t latency_us_max;    ///< Maximum enqueue to commit latency in microseconds
+} voice_queue_stats_t;
+
+/// Voice jitter buffer statistics
+typedef struct {
+   uint32_t target_delay_ms;        ///< Current adaptive playout delay
+   uint32_t jitter_ms;              ///< Inter-arrival jitter estimate
+   uint32_t buffered_ms;            ///< Audio currently held in the jitter buffer
+   uint32_t added_latency_ms_avg;   ///< Average delay added to released frames
+   uint32_t added_latency_ms_max;   ///< Maximum delay added to released frames
+   uint64_t underruns;              ///< Times the buffer ran dry during playout
+   uint64_t overflows;              ///< Times old audio was discarded to make room
+   uint64_t frames_released;        ///< Frames released to the shared data stream
+} voice_jitter_stats_t;
+
+/// Voice sequence statistics for the current session
+typedef struct {
+   uint64_t frames_received;    ///< Sequenced frames received
+   uint64_t frames_lost;        ///< Frames that never arrived within the reorder window
+   uint64_t frames_reordered;   ///< Frames that arrived out of order and were put back in sequence
+   uint64_t frames_concealed;   ///< Frames synthesized to cover losses
+   uint64_t frames_late;        ///< Frames dropped because they arrived after their position was released
+} voice_sequence_stats_t;
+
+/// Opus upload encoder statistics for the current utterance
+typedef struct {
+   uint64_t frames_encoded;   ///< Opus frames written to the shared data stream
+   uint64_t bytes_in;         ///< PCM bytes consumed
+   uint64_t bytes_out;        ///< Encoded bytes uploaded through the recognize event
+   uint64_t encode_us;        ///< Time spent encoding in microseconds
+} voice_encoder_stats_t;
+
+/// Recognize state machine counters and time spent in each dialog state since start up
+typedef struct {
+   uint32_t starts;           ///< Recognizes opened
+   uint32_t stops;            ///< Recognizes closed by the end of the stream
+   uint32_t cancels;          ///< Recognizes cancelled
+   uint32_t preemptions;      ///< Starts that interrupted a THINKING or SPEAKING dialog
+   uint32_t ignored;          ///< Duplicated starts and stops without an open recognize
+   uint64_t idle_ms;          ///< Time spent IDLE in milliseconds
+   uint64_t listening_ms;     ///< Time spent LISTENING in milliseconds
+   uint64_t expecting_ms;     ///< Time spent EXPECTING in milliseconds
+   uint64_t thinking_ms;      ///< Time spent THINKING in milliseconds
+   uint64_t speaking_ms;      ///< Time spent SPEAKING in milliseconds
+} voice_recognize_stats_t;
+
+/// Local end-pointer result of the last session and totals since start up
+typedef struct {
+   uint32_t speech_ms;            ///< Speech detected in the last session
+   uint32_t end_of_speech_ms;     ///< Stream time of the local end of speech, 0 if none was declared
+   uint32_t time_saved_ms;        ///< Time between the local end of speech and the end of the stream
+   bool     end_of_speech;        ///< True if the last session was end-pointed locally
+   uint32_t endpoints;            ///< Sessions end-pointed locally
+   uint64_t time_saved_total_ms;  ///< Sum of time_saved_ms over all sessions
+} voice_endpoint_stats_t;
+
+/// Leading silence trimmed ahead of the upload
+typedef struct {
+   uint32_t trimmed_ms;           ///< Leading audio trimmed from the last session
+   bool     onset;                ///< True if speech onset was found in the last session
+   uint64_t sessions;             ///< Sessions trimmed since start up
+   uint64_t trimmed_total_ms;     ///< Sum of trimmed_ms over all sessions
+} voice_trim_stats_t;
+
+/// Noise suppressor frame processing cost, one frame covers hop_ms of audio
+typedef struct {
+   uint64_t frames;               ///< Frames processed since start up
+   uint32_t frame_us_avg;         ///< Average processing time per frame in microseconds
+   uint32_t frame_us_max;         ///< Longest processing time of a frame in microseconds
+   uint32_t hop_ms;               ///< Audio advanced per frame in milliseconds
+   bool     bypassed;             ///< True if the current session exceeded the CPU budget and is passed through
+} voice_noise_suppressor_stats_t;
+
+/// Echo canceller convergence and processing cost, one frame covers block_ms of audio
+typedef struct {
+   uint64_t frames;               ///< Blocks processed since start up
+   uint64_t active_frames;        ///< Blocks processed while the media players were rendering audio
+   float    erle_db;              ///< Smoothed echo return loss enhancement in dB
+   uint32_t delay_ms;             ///< Playback to capture delay applied to the reference
+   bool     delay_locked;         ///< True once the delay has been estimated
+   uint32_t frame_us_avg;         ///< Average processing time per block in microseconds
+   uint32_t frame_us_max;         ///< Longest processing time of a block in microseconds
+   uint32_t block_ms;             ///< Audio per block in milliseconds
+} voice_echo_canceller_stats_t;
+
+/// Input level of the received audio in dB relative to full scale, for the last frame and the current session
+typedef struct {
+   float    rms_dbfs;             ///< RMS of the last frame
+   float    peak_dbfs;            ///< Peak of the last frame
+   uint32_t clips;                ///< Full scale samples in the last frame
+   uint64_t session_frames;       ///< Frames metered in the current or last session
+   float    session_rms_dbfs_min; ///< Quietest frame of the session
+   float    session_rms_dbfs_mean;///< RMS over the whole session
+   float    session_rms_dbfs_max; ///< Loudest frame of the session
+   float    session_peak_dbfs;    ///< Peak of the session
+   uint64_t session_clips;        ///< Full scale samples in the session
+} voice_level_stats_t;
+
+/// Capture to upload latency percentiles since start up. Capture times are derived from the stream begin time.
+typedef struct {
+   uint64_t write_count;          ///< Shared data stream writes measured
+   uint32_t write_p50_us;         ///< Capture to shared data stream write latency
+   uint32_t write_p95_us;
+   uint32_t write_p99_us;
+   uint32_t write_max_us;
+   uint64_t upload_count;         ///< Recognizes measured
+   uint32_t upload_p50_us;        ///< Capture of the last sample to the end of the recognize capture
+   uint32_t upload_p95_us;
+   uint32_t upload_p99_us;
+   uint32_t upload_max_us;
+   uint32_t upload_last_us;       ///< Latency of the last recognize
+} voice_latency_stats_t;
+
+/// Voice session timeline events reported by the audio source
+typedef enum {
+   VOICE_TRACE_SESSION_BEGIN = 0,   ///< Session opened, starts a new timeline
+   VOICE_TRACE_STREAM_BEGIN  = 1,   ///< First audio of the stream
+   VOICE_TRACE_STREAM_KWD    = 2,   ///< Keyword detected in the stream
+   VOICE_TRACE_STREAM_END    = 3,   ///< Last audio of the stream
+   VOICE_TRACE_SESSION_END   = 4    ///< Session closed by the audio source
+} voice_trace_event_t;
+
+/// Phase latencies of the last completed session timeline in milliseconds, -1 if the phase did not happen
+typedef struct {
+   char     session_id[37];       ///< Session uuid given to VOICE_TRACE_SESSION_BEGIN
+   int32_t  first_write_ms;       ///< Stream begin to the first shared data stream write
+   int32_t  listen_ms;            ///< Stream begin to stream end
+   int32_t  end_to_think_ms;      ///< Stream end to THINKING
+   int32_t  think_ms;             ///< THINKING to SPEAKING
+   int32_t  speak_directive_ms;   ///< Stream end to the Speak directive
+   int32_t  first_audio_ms;       ///< Stream end to the first response audio
+   int32_t  total_ms;             ///< Session begin to the last event of the timeline
+} voice_session_trace_t;
+
+/// VoiceToApps dispatch queue statistics since start up
+typedef struct {
+   uint64_t posted;               ///< Messages queued for the apps
+   uint64_t dispatched;           ///< Messages sent to the apps
+   uint64_t dropped;              ///< Messages dropped because the queue was full
+   uint32_t depth;                ///< Messages currently queued
+   uint32_t wait_us_avg;          ///< Average time a message waited in the queue
+   uint32_t wait_us_max;
+   uint32_t dispatch_us_avg;      ///< Average time to send a message
+   uint32_t dispatch_us_max;
+} voice_dispatch_stats_t;
+
+/// Called on an end-pointer notification thread, not the ingest thread, when the local end-pointer detects the end of
+/// speech. The handler may stop the stream from within the call.
+typedef void (*voice_end_of_speech_handler_t)(void *user_data);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 void AVS_Initialize();
 void AVS_DeInitialize();
+/// Sets the SDK log level at run time, tag is a log source (e.g. "AudioInputProcessor") or NULL for every source
+/// without a level of its own. level is a configuration level name: "DEBUG9".."DEBUG0", "INFO", "WARN", "ERROR",
+/// "CRITICAL" or "NONE". Up to 32 tags. A tag level more verbose than the global one is not free: every SDK source
+/// then formats its entries down to that level and the ones below their own level are discarded after formatting.
+bool AVS_SetLogLevel(const char *tag, const char *level);
+/// The tag follows the global level again
+void AVS_ClearLogLevel(const char *tag);
 
 void Voice_Start();
 void Voice_Stop();
+/// Abandons the current recognize and any response still pending for it
+void Voice_Cancel();
 void Voice_Data(const uint32_t seq,const uint8_t dataBuffer[], const uint16_t length);
+/// Commits count frames in a single call, frame n is given sequence number seq + n (seq 0 for unsequenced sources).
+/// A batch larger than the free staging space is queued in parts as it drains, waiting up to 500 ms for space.
+/// Returns the number of frames accepted, frames after those were dropped. A batch holding an empty frame is rejected.
+uint32_t Voice_DataV(const uint32_t seq, const struct iovec *frames, const uint32_t count);
+/// Sets the interleaved 16-bit PCM input format (8000/16000/22050/44100/48000 Hz, 1-4 channels) from the next session.
+/// Returns false if the current input codec cannot decode that format (ADPCM is mono, Opus 8/16/48 kHz mono or stereo).
+bool Voice_SetInputFormat(const uint32_t sample_rate_hz, const uint32_t channels);
+/// Sets the codec of the frames passed to Voice_Data/Voice_DataV from the next session. Returns false if the codec
+/// cannot decode the current input format or is not supported by this build, switch the format first when both change.
+bool Voice_SetInputCodec(const voice_codec_t codec);
+/// Sets the keyword position in input samples from the start of the next stream, the session then opens a wake word
+/// recognize with the pre-roll and keyword kept in the upload. Pass 0, 0 for push to talk.
+bool Voice_SetKeyword(const uint32_t sample_begin, const uint32_t sample_end);
+bool Voice_GetQueueStats(voice_queue_stats_t *stats);
+bool Voice_GetJitterStats(voice_jitter_stats_t *stats);
+bool Voice_GetSequenceStats(voice_sequence_stats_t *stats);
+bool Voice_GetEncoderStats(voice_encoder_stats_t *stats);
+bool Voice_GetRecognizeStats(voice_recognize_stats_t *stats);
+void Voice_SetEndOfSpeechHandler(voice_end_of_speech_handler_t handler, void *user_data);
+bool Voice_GetEndpointStats(voice_endpoint_stats_t *stats);
+bool Voice_GetTrimStats(voice_trim_stats_t *stats);
+bool Voice_GetNoiseSuppressorStats(voice_noise_suppressor_stats_t *stats);
+bool Voice_GetEchoCancellerStats(voice_echo_canceller_stats_t *stats);
+/// Lock-free, may be polled from any thread at any rate
+bool Voice_GetLevelStats(voice_level_stats_t *stats);
+/// Steady clock (CLOCK_MONOTONIC) time the next stream began, call ahead of Voice_Start
+void Voice_SetStreamBeginTime(const uint64_t time_ns);
+bool Voice_GetLatencyStats(voice_latency_stats_t *stats);
+bool Voice_GetDispatchStats(voice_dispatch_stats_t *stats);
+/// Records a timeline event at the steady clock time_ns (0 for now), session_id is only used by VOICE_TRACE_SESSION_BEGIN
+void Voice_TraceEvent(const voice_trace_event_t event, const char *session_id, const uint64_t time_ns);
+bool Voice_GetSessionTrace(voice_session_trace_t *trace);
+/// Writes the recent session timelines as Chrome trace event JSON, returns the length needed excluding the terminator
+size_t Voice_ExportSessionTraces(char *buffer, const size_t size);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,178 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AsyncLogWriter.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace WPEFramework {
+
+    // Backstop for a wake up lost between the writer going to sleep and a producer posting
+    static const std::chrono::milliseconds WRITER_IDLE_WAIT = std::chrono::milliseconds(50);
+
+    // Bounded copy of a C string, returns true if it had to be cut
+    static bool CopyTruncated(char out[], const size_t size, const char* text)
+    {
+        const size_t length = text != nullptr ? strnlen(text, size) : 0;
+        if (length == size) {
+            std::memcpy(out, text, size - 1);
+            out[size - 1] = '\0';
+            return true;
+        }
+        std::memcpy(out, text, length);
+        out[length] = '\0';
+        return false;
+    }
+
+    std::unique_ptr<AsyncLogWriter> AsyncLogWriter::create(const size_t capacity)
+    {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            XLOGD_ERROR("Invalid log writer capacity <%zu>", capacity);
+            return nullptr;
+        }
+        return std::unique_ptr<AsyncLogWriter>(new AsyncLogWriter(capacity));
+    }
+
+    AsyncLogWriter::AsyncLogWriter(const size_t capacity)
+        : m_capacity(capacity)
+        , m_mask(capacity - 1)
+        , m_entries(new Entry[capacity])
+        , m_head(0)
+        , m_tail(0)
+        , m_running(true)
+        , m_sleeping(false)
+        , m_posted(0)
+        , m_dropped(0)
+        , m_truncated(0)
+        , m_written(0)
+        , m_droppedReported(0)
+    {
+        // Entry n is free for the producer claiming position n
+        for (size_t index = 0; index < capacity; index++) {
+            m_entries[index].sequence.store(index, std::memory_order_relaxed);
+        }
+        m_thread = std::thread(&AsyncLogWriter::Worker, this);
+    }
+
+    AsyncLogWriter::~AsyncLogWriter()
+    {
+        {
+            const std::lock_guard<std::mutex> lock{ m_mutex };
+            m_running = false;
+        }
+        m_wakeUp.notify_one();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    bool AsyncLogWriter::Post(const char level, const char* moniker, const char* text)
+    {
+        uint64_t position = m_head.load(std::memory_order_relaxed);
+        Entry* entry;
+        for (;;) {
+            entry = &m_entries[position & m_mask];
+            const uint64_t sequence = entry->sequence.load(std::memory_order_acquire);
+            const int64_t difference = static_cast<int64_t>(sequence - position);
+            if (difference == 0) {
+                if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                // The writer has not released this entry yet, the ring is full
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                position = m_head.load(std::memory_order_relaxed);
+            }
+        }
+
+        entry->level = level;
+        CopyTruncated(entry->moniker, MONIKER_MAX, moniker);
+        if (CopyTruncated(entry->text, TEXT_MAX, text)) {
+            m_truncated.fetch_add(1, std::memory_order_relaxed);
+        }
+        entry->sequence.store(position + 1, std::memory_order_release);
+        m_posted.fetch_add(1, std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleeping.load(std::memory_order_relaxed)) {
+            const std::lock_guard<std::mutex> lock{ m_mutex };
+            m_wakeUp.notify_one();
+        }
+        return true;
+    }
+
+    AsyncLogWriter::Stats AsyncLogWriter::GetStats() const
+    {
+        Stats stats;
+        stats.posted = m_posted.load(std::memory_order_relaxed);
+        stats.dropped = m_dropped.load(std::memory_order_relaxed);
+        stats.truncated = m_truncated.load(std::memory_order_relaxed);
+        stats.written = m_written.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    bool AsyncLogWriter::WriteNext()
+    {
+        Entry& entry = m_entries[m_tail & m_mask];
+        if (entry.sequence.load(std::memory_order_acquire) != m_tail + 1) {
+            return false;
+        }
+
+        XLOGD_DEBUG("[%s] %c %s", entry.moniker, entry.level, entry.text);
+
+        entry.sequence.store(m_tail + m_capacity, std::memory_order_release);
+        m_tail++;
+        m_written.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void AsyncLogWriter::Worker()
+    {
+        for (;;) {
+            while (WriteNext()) {
+            }
+
+            const uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+            if (dropped != m_droppedReported) {
+                XLOGD_WARN("Dropped <%llu> log lines, the log writer fell behind", (unsigned long long)(dropped - m_droppedReported));
+                m_droppedReported = dropped;
+            }
+
+            std::unique_lock<std::mutex> lock{ m_mutex };
+            if (!m_running) {
+                break;
+            }
+            m_sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_entries[m_tail & m_mask].sequence.load(std::memory_order_acquire) != m_tail + 1) {
+                m_wakeUp.wait_for(lock, WRITER_IDLE_WAIT);
+            }
+            m_sleeping.store(false, std::memory_order_relaxed);
+        }
+
+        // Everything posted ahead of the destructor is written
+        while (WriteNext()) {
+        }
+    }
+
+} // namespace WPEFramework
@@ -0,0 +1,95 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+
+namespace WPEFramework {
+
+    /**
+     * Moves log output off the calling thread. Lines are copied into fixed size entries of a bounded lock-free
+     * multi producer ring and a background thread formats them and hands them to rdkx_logger. Posting never
+     * allocates, formats or takes a lock unless the writer thread is asleep. Lines are truncated to the entry
+     * size and dropped, and counted, when the ring is full. The destructor drains the ring. Thread safe.
+    */
+    class AsyncLogWriter {
+    public:
+        static constexpr size_t MONIKER_MAX = 16;
+        static constexpr size_t TEXT_MAX = 1000;
+
+        struct Stats {
+            uint64_t posted;
+            uint64_t dropped;
+            uint64_t truncated;
+            uint64_t written;
+        };
+
+        /// @param capacity Number of entries, must be a power of two
+        static std::unique_ptr<AsyncLogWriter> create(const size_t capacity);
+
+        AsyncLogWriter(const AsyncLogWriter&) = delete;
+        AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+        ~AsyncLogWriter();
+
+        /// Producer side, any thread. Returns false if the line was dropped.
+        bool Post(const char level, const char* moniker, const char* text);
+
+        Stats GetStats() const;
+
+    private:
+        struct Entry {
+            std::atomic<uint64_t> sequence;
+            char level;
+            char moniker[MONIKER_MAX];
+            char text[TEXT_MAX];
+        };
+
+        AsyncLogWriter(const size_t capacity);
+
+        void Worker();
+        bool WriteNext();
+
+    private:
+        const size_t m_capacity;
+        const uint64_t m_mask;
+        std::unique_ptr<Entry[]> m_entries;
+        std::atomic<uint64_t> m_head;
+        uint64_t m_tail;
+        std::atomic<bool> m_running;
+        std::atomic<bool> m_sleeping;
+        std::mutex m_mutex;
+        std::condition_variable m_wakeUp;
+        std::atomic<uint64_t> m_posted;
+        std::atomic<uint64_t> m_dropped;
+        std::atomic<uint64_t> m_truncated;
+        std::atomic<uint64_t> m_written;
+        uint64_t m_droppedReported;
+        std::thread m_thread;
+    };
+
+} // namespace WPEFramework
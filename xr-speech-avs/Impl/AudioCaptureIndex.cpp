@@ -0,0 +1,68 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioCaptureIndex.h"
+
+namespace WPEFramework {
+
+    std::unique_ptr<AudioCaptureIndex> AudioCaptureIndex::create(const size_t capacity)
+    {
+        if (capacity == 0) {
+            XLOGD_ERROR("Invalid capture index capacity");
+            return nullptr;
+        }
+        return std::unique_ptr<AudioCaptureIndex>(new AudioCaptureIndex(capacity));
+    }
+
+    AudioCaptureIndex::AudioCaptureIndex(const size_t capacity)
+        : m_entries(capacity)
+        , m_head(0)
+        , m_size(0)
+    {
+    }
+
+    void AudioCaptureIndex::Add(const Entry& entry)
+    {
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        m_entries[m_head] = entry;
+        m_head = (m_head + 1) % m_entries.size();
+        if (m_size < m_entries.size()) {
+            m_size++;
+        }
+    }
+
+    bool AudioCaptureIndex::Lookup(const uint64_t wordIndex, Entry& entry)
+    {
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        // Word offsets only grow, search back from the newest entry
+        for (size_t count = 0; count < m_size; count++) {
+            const Entry& candidate = m_entries[(m_head + m_entries.size() - 1 - count) % m_entries.size()];
+            if (wordIndex >= candidate.wordIndex) {
+                if (wordIndex >= candidate.wordIndex + candidate.wordCount) {
+                    return false;
+                }
+                entry = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace WPEFramework
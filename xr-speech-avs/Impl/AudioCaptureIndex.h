@@ -0,0 +1,65 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+namespace WPEFramework {
+
+    /// Side channel of the shared data stream: the capture and write times of the audio, indexed by SDS word
+    /// offset. One entry is added per write, entries are kept for as long as the SDS can hold the audio they
+    /// describe. Thread safe, written by the SDS writer thread and looked up when the audio is consumed.
+    class AudioCaptureIndex {
+    public:
+        struct Entry {
+            uint64_t wordIndex;       ///< SDS offset of the first word of the write
+            uint64_t wordCount;
+            uint64_t captureNs;       ///< Steady clock capture time of the last sample of the write
+            uint64_t writtenNs;
+        };
+
+        static std::unique_ptr<AudioCaptureIndex> create(const size_t capacity);
+
+        AudioCaptureIndex(const AudioCaptureIndex&) = delete;
+        AudioCaptureIndex& operator=(const AudioCaptureIndex&) = delete;
+        ~AudioCaptureIndex() = default;
+
+        void Add(const Entry& entry);
+
+        /// Finds the write that holds the word at wordIndex
+        bool Lookup(const uint64_t wordIndex, Entry& entry);
+
+    private:
+        explicit AudioCaptureIndex(const size_t capacity);
+
+    private:
+        std::mutex m_mutex;
+        std::vector<Entry> m_entries;
+        size_t m_head;
+        size_t m_size;
+    };
+
+} // namespace WPEFramework
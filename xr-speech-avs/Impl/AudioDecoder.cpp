@@ -0,0 +1,227 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioDecoder.h"
+
+#include <chrono>
+#include <cstring>
+
+#if defined(OPUS_SUPPORT)
+#include <opus.h>
+#endif
+
+namespace WPEFramework {
+
+    // IMA ADPCM block header: int16 predictor, uint8 step index, uint8 reserved
+    static const size_t ADPCM_HEADER_SIZE = 4;
+    // Worst case output reserved per session, 120 ms at 48 kHz stereo
+    static const size_t DECODE_RESERVE_SAMPLES = 5760 * 2;
+
+    static const int16_t ADPCM_STEP_TABLE[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+        107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+        876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428,
+        4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+        22385, 24623, 27086, 29794, 32767
+    };
+
+    static const int8_t ADPCM_INDEX_TABLE[16] = {
+        -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8
+    };
+
+    /// Stateless per block, every frame carries its own predictor state
+    class AdpcmImaDecoder : public AudioDecoder {
+    public:
+        AdpcmImaDecoder(const uint32_t sampleRateHz)
+            : AudioDecoder(Codec::ADPCM_IMA, sampleRateHz, 1)
+        {
+        }
+
+    protected:
+        int DecodeFrame(const uint8_t data[], const size_t length, int16_t out[], const size_t outSamples) override
+        {
+            if (length < ADPCM_HEADER_SIZE) {
+                return -1;
+            }
+
+            int32_t predictor = static_cast<int16_t>(data[0] | (data[1] << 8));
+            int32_t index = data[2];
+            if (index > 88) {
+                return -1;
+            }
+
+            const size_t samples = (length - ADPCM_HEADER_SIZE) * 2;
+            if (samples > outSamples) {
+                return -1;
+            }
+
+            for (size_t sample = 0; sample < samples; sample++) {
+                const uint8_t byte = data[ADPCM_HEADER_SIZE + sample / 2];
+                const uint8_t nibble = (sample & 1) ? (byte >> 4) : (byte & 0x0F);
+                const int32_t step = ADPCM_STEP_TABLE[index];
+
+                int32_t diff = step >> 3;
+                if (nibble & 4) diff += step;
+                if (nibble & 2) diff += step >> 1;
+                if (nibble & 1) diff += step >> 2;
+                predictor += (nibble & 8) ? -diff : diff;
+                predictor = predictor > 32767 ? 32767 : (predictor < -32768 ? -32768 : predictor);
+
+                index += ADPCM_INDEX_TABLE[nibble];
+                index = index < 0 ? 0 : (index > 88 ? 88 : index);
+
+                out[sample] = static_cast<int16_t>(predictor);
+            }
+            return static_cast<int>(samples);
+        }
+
+        void ResetState() override
+        {
+        }
+
+        size_t MaxSamples(const size_t length) const override
+        {
+            return length * 2;
+        }
+    };
+
+#if defined(OPUS_SUPPORT)
+    class OpusFrameDecoder : public AudioDecoder {
+    public:
+        static std::unique_ptr<AudioDecoder> create(const uint32_t sampleRateHz, const uint32_t numChannels)
+        {
+            int error = OPUS_OK;
+            OpusDecoder* decoder = opus_decoder_create(sampleRateHz, numChannels, &error);
+            if (decoder == nullptr || error != OPUS_OK) {
+                XLOGD_ERROR("Failed to create opus decoder <%s>", opus_strerror(error));
+                return nullptr;
+            }
+            return std::unique_ptr<AudioDecoder>(new OpusFrameDecoder(decoder, sampleRateHz, numChannels));
+        }
+
+        ~OpusFrameDecoder()
+        {
+            opus_decoder_destroy(m_decoder);
+        }
+
+    protected:
+        int DecodeFrame(const uint8_t data[], const size_t length, int16_t out[], const size_t outSamples) override
+        {
+            const int frames = opus_decode(m_decoder, data, static_cast<opus_int32>(length), out, static_cast<int>(outSamples / GetNumChannels()), 0);
+            return frames < 0 ? frames : frames * static_cast<int>(GetNumChannels());
+        }
+
+        void ResetState() override
+        {
+            opus_decoder_ctl(m_decoder, OPUS_RESET_STATE);
+        }
+
+        size_t MaxSamples(const size_t) const override
+        {
+            // Opus packets carry at most 120 ms
+            return static_cast<size_t>(GetSampleRateHz()) * 120 / 1000 * GetNumChannels();
+        }
+
+    private:
+        OpusFrameDecoder(OpusDecoder* decoder, const uint32_t sampleRateHz, const uint32_t numChannels)
+            : AudioDecoder(Codec::OPUS, sampleRateHz, numChannels)
+            , m_decoder{ decoder }
+        {
+        }
+
+    private:
+        OpusDecoder* m_decoder;
+    };
+#endif
+
+    bool AudioDecoder::IsSupported(const Codec codec, const uint32_t sampleRateHz, const uint32_t numChannels)
+    {
+        switch (codec) {
+        case Codec::PCM_16:
+            return true;
+        case Codec::ADPCM_IMA:
+            return numChannels == 1;
+        case Codec::OPUS:
+#if defined(OPUS_SUPPORT)
+            // libopus decodes to these rates only
+            return (sampleRateHz == 8000 || sampleRateHz == 12000 || sampleRateHz == 16000 || sampleRateHz == 24000 || sampleRateHz == 48000) &&
+                (numChannels == 1 || numChannels == 2);
+#else
+            (void)sampleRateHz;
+            return false;
+#endif
+        }
+        return false;
+    }
+
+    std::unique_ptr<AudioDecoder> AudioDecoder::create(const Codec codec, const uint32_t sampleRateHz, const uint32_t numChannels)
+    {
+        switch (codec) {
+        case Codec::PCM_16:
+            return nullptr;
+        case Codec::ADPCM_IMA:
+            if (numChannels != 1) {
+                XLOGD_ERROR("IMA ADPCM supports mono only");
+                return nullptr;
+            }
+            return std::unique_ptr<AudioDecoder>(new AdpcmImaDecoder(sampleRateHz));
+        case Codec::OPUS:
+#if defined(OPUS_SUPPORT)
+            return OpusFrameDecoder::create(sampleRateHz, numChannels);
+#else
+            XLOGD_ERROR("Opus support is not compiled in");
+            return nullptr;
+#endif
+        }
+        return nullptr;
+    }
+
+    bool AudioDecoder::Decode(const uint8_t data[], const size_t length, std::vector<uint8_t>& out)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const size_t maxSamples = MaxSamples(length);
+        const size_t offset = out.size();
+
+        if (out.capacity() < DECODE_RESERVE_SAMPLES * sizeof(int16_t)) {
+            out.reserve(DECODE_RESERVE_SAMPLES * sizeof(int16_t));
+        }
+        out.resize(offset + maxSamples * sizeof(int16_t));
+
+        const int samples = DecodeFrame(data, length, reinterpret_cast<int16_t*>(&out[offset]), maxSamples);
+        if (samples < 0) {
+            out.resize(offset);
+            m_stats.errors++;
+            return false;
+        }
+        out.resize(offset + samples * sizeof(int16_t));
+
+        m_stats.frames++;
+        m_stats.samples += samples;
+        m_stats.decodeUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        return true;
+    }
+
+    void AudioDecoder::Reset()
+    {
+        ResetState();
+        m_stats = Stats();
+    }
+
+} // namespace WPEFramework
@@ -0,0 +1,91 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace WPEFramework {
+
+    /// Decodes compressed voice frames to 16-bit PCM inside the ingest pipeline. One instance serves one session
+    /// at a time, working buffers are allocated up front so decoding does not allocate.
+    /// Not thread safe, it is owned and driven by the SDS writer thread.
+    class AudioDecoder {
+    public:
+        enum class Codec {
+            PCM_16,     ///< Uncompressed, no decoder is needed
+            ADPCM_IMA,  ///< IMA ADPCM blocks: int16 predictor, uint8 step index, uint8 reserved, then 4-bit samples low nibble first
+            OPUS        ///< One Opus packet per frame
+        };
+
+        struct Stats {
+            uint64_t frames;
+            uint64_t errors;
+            uint64_t samples;
+            uint64_t decodeUs;
+        };
+
+        /// Returns false when frames of codec at this rate and channel count cannot be decoded by this build
+        static bool IsSupported(const Codec codec, const uint32_t sampleRateHz, const uint32_t numChannels);
+
+        /// Returns nullptr for PCM_16 or when the codec is unsupported in this build or format
+        static std::unique_ptr<AudioDecoder> create(const Codec codec, const uint32_t sampleRateHz, const uint32_t numChannels);
+
+        AudioDecoder(const AudioDecoder&) = delete;
+        AudioDecoder& operator=(const AudioDecoder&) = delete;
+        virtual ~AudioDecoder() = default;
+
+        /// Decodes one frame and appends the PCM samples to out
+        bool Decode(const uint8_t data[], const size_t length, std::vector<uint8_t>& out);
+
+        /// Resets the codec state and the statistics, used between sessions
+        void Reset();
+
+        Codec GetCodec() const { return m_codec; }
+        uint32_t GetSampleRateHz() const { return m_sampleRateHz; }
+        uint32_t GetNumChannels() const { return m_numChannels; }
+        Stats GetStats() const { return m_stats; }
+
+    protected:
+        AudioDecoder(const Codec codec, const uint32_t sampleRateHz, const uint32_t numChannels)
+            : m_codec{ codec }
+            , m_sampleRateHz{ sampleRateHz }
+            , m_numChannels{ numChannels }
+            , m_stats()
+        {
+        }
+
+        /// Returns the number of samples written to out, or a negative value on error
+        virtual int DecodeFrame(const uint8_t data[], const size_t length, int16_t out[], const size_t outSamples) = 0;
+        virtual void ResetState() = 0;
+        virtual size_t MaxSamples(const size_t length) const = 0;
+
+    private:
+        const Codec m_codec;
+        const uint32_t m_sampleRateHz;
+        const uint32_t m_numChannels;
+        Stats m_stats;
+    };
+
+} // namespace WPEFramework
@@ -0,0 +1,322 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioEchoCanceller.h"
+#include "AudioSimd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+
+namespace WPEFramework {
+
+    static const uint32_t PCM16_BYTES = 2;
+    // Block of the delay estimator and the statistics, 4 ms at 16 kHz
+    static const size_t BLOCK_SAMPLES = 64;
+    static const size_t DELAY_WINDOW_BLOCKS = 128;
+    static const size_t DELAY_CHECK_BLOCKS = 16;
+    static const float DELAY_MIN_CORRELATION = 0.4f;
+    // A locked delay only moves for a clearly better match
+    static const float DELAY_SWITCH_MARGIN = 0.1f;
+    static const size_t NO_LAG = static_cast<size_t>(-1);
+    static const float NLMS_STEP = 0.3f;
+    // Per tap, keeps the step bounded while the reference is very quiet
+    static const float NLMS_REGULARIZATION = 1e4f;
+    // Near end louder than half the recent reference peak is taken as local speech
+    static const float GEIGEL_THRESHOLD = 0.5f;
+    static const uint32_t DOUBLE_TALK_HOLD_MS = 30;
+    static const float ENERGY_EPSILON = 1.0f;
+    // Envelopes are floored near -50 dBFS so room noise and digital silence look alike
+    static const float ENVELOPE_FLOOR = 1e4f * BLOCK_SAMPLES;
+    static const float ERLE_WEIGHT = 1.0f / 16;
+
+    std::unique_ptr<AudioEchoCanceller> AudioEchoCanceller::create(const Config& config, std::shared_ptr<AudioReference> reference)
+    {
+        if (config.sampleRateHz == 0 || config.tailMs == 0 || !reference || reference->SampleRateHz() != config.sampleRateHz) {
+            XLOGD_ERROR("Invalid echo canceller configuration");
+            return nullptr;
+        }
+        const size_t taps = (static_cast<size_t>(config.sampleRateHz) * config.tailMs / 1000 + AudioSimd::AUDIO_SIMD_WIDTH - 1) &
+            ~(AudioSimd::AUDIO_SIMD_WIDTH - 1);
+        const size_t maxLagBlocks = static_cast<size_t>(config.sampleRateHz) * config.maxDelayMs / 1000 / BLOCK_SAMPLES;
+        return std::unique_ptr<AudioEchoCanceller>(new AudioEchoCanceller(config, reference, taps, maxLagBlocks));
+    }
+
+    AudioEchoCanceller::AudioEchoCanceller(const Config& config, std::shared_ptr<AudioReference> reference, const size_t taps, const size_t maxLagBlocks)
+        : m_config(config)
+        , m_reference(reference)
+        , m_taps(taps)
+        , m_maxLagBlocks(maxLagBlocks)
+        , m_weights(taps, 0.0f)
+        , m_far(taps - 1 + BLOCK_SAMPLES)
+        , m_near(BLOCK_SAMPLES)
+        , m_error(BLOCK_SAMPLES)
+        , m_block(BLOCK_SAMPLES)
+        , m_pcm(BLOCK_SAMPLES)
+        , m_micPosition(0)
+        , m_anchored(false)
+        , m_delaySamples(0)
+        , m_doubleTalkHold(0)
+        , m_blockFill(0)
+        , m_blockNear(0.0f)
+        , m_blockError(0.0f)
+        , m_blockActive(false)
+        , m_blockDoubleTalk(false)
+        , m_blockNs(0)
+        , m_micEnvelope(DELAY_WINDOW_BLOCKS, 0.0f)
+        , m_refEnvelope(DELAY_WINDOW_BLOCKS + maxLagBlocks, 0.0f)
+        , m_envelopeBlocks(0)
+        , m_lastMicLog(0.0f)
+        , m_lastRefLog(0.0f)
+        , m_candidateLag(NO_LAG)
+        , m_delayLocked(false)
+        , m_frames(0)
+        , m_activeFrames(0)
+        , m_erleDb(0.0f)
+        , m_frameNsTotal(0)
+        , m_frameNsMax(0)
+    {
+    }
+
+    void AudioEchoCanceller::Process(const uint8_t data[], const size_t length, const uint64_t arrivalNs, std::vector<uint8_t>& out)
+    {
+        const int16_t* samples = reinterpret_cast<const int16_t*>(data);
+        const size_t count = length / PCM16_BYTES;
+        if (count == 0) {
+            return;
+        }
+
+        // Follow the earliest arrival, late ones are delivery jitter unless they leave the delay search range
+        const uint64_t anchor = m_reference->Position(arrivalNs) - count;
+        const uint64_t maxDelay = static_cast<uint64_t>(m_maxLagBlocks) * BLOCK_SAMPLES;
+        if (!m_anchored || anchor + BLOCK_SAMPLES < m_micPosition || anchor > m_micPosition + maxDelay) {
+            if (m_anchored) {
+                XLOGD_INFO("Microphone timeline re-anchored by <%lld> samples", static_cast<long long>(anchor - m_micPosition));
+            }
+            m_micPosition = anchor;
+            m_anchored = true;
+        }
+
+        size_t offset = 0;
+        while (offset < count) {
+            const size_t chunk = std::min(count - offset, BLOCK_SAMPLES - m_blockFill);
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+            Cancel(samples + offset, chunk, out);
+            m_micPosition += chunk;
+            m_blockFill += chunk;
+            offset += chunk;
+
+            m_blockNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            if (m_blockFill == BLOCK_SAMPLES) {
+                EndBlock();
+            }
+        }
+    }
+
+    void AudioEchoCanceller::Cancel(const int16_t samples[], const size_t count, std::vector<uint8_t>& out)
+    {
+        const size_t window = m_taps - 1 + count;
+        const bool active = m_reference->Read(m_micPosition + count - m_delaySamples, m_far.data(), window);
+
+        float nearEnergy = 0.0f;
+        float errorEnergy = 0.0f;
+        const uint8_t* pcm = reinterpret_cast<const uint8_t*>(samples);
+        if (active) {
+            float farPeak = 0.0f;
+            for (size_t index = 0; index < window; index++) {
+                farPeak = std::max(farPeak, fabsf(m_far[index]));
+            }
+
+            const size_t holdSamples = static_cast<size_t>(m_config.sampleRateHz) * DOUBLE_TALK_HOLD_MS / 1000;
+            const float regularization = NLMS_REGULARIZATION * m_taps;
+            float farEnergy = AudioSimd::DotProduct(m_far.data(), m_far.data(), m_taps);
+            for (size_t index = 0; index < count; index++) {
+                const float* far = &m_far[index];
+                const float near = samples[index];
+                const float error = near - AudioSimd::DotProduct(m_weights.data(), far, m_taps);
+
+                if (fabsf(near) > GEIGEL_THRESHOLD * farPeak) {
+                    m_doubleTalkHold = holdSamples;
+                }
+                if (m_doubleTalkHold > 0) {
+                    m_doubleTalkHold--;
+                    m_blockDoubleTalk = true;
+                } else {
+                    AudioSimd::Axpy(m_weights.data(), far, NLMS_STEP * error / (farEnergy + regularization), m_taps);
+                }
+                if (index + 1 < count) {
+                    farEnergy = std::max(farEnergy + far[m_taps] * far[m_taps] - far[0] * far[0], 0.0f);
+                }
+
+                m_error[index] = error;
+                nearEnergy += near * near;
+                errorEnergy += error * error;
+            }
+
+            // An unconverged or diverging filter must not add echo, the microphone is passed through instead
+            if (errorEnergy < nearEnergy) {
+                AudioSimd::FloatToPcm16(m_error.data(), m_pcm.data(), count);
+                pcm = reinterpret_cast<const uint8_t*>(m_pcm.data());
+            } else {
+                errorEnergy = nearEnergy;
+            }
+            m_blockActive = true;
+        } else {
+            for (size_t index = 0; index < count; index++) {
+                nearEnergy += static_cast<float>(samples[index]) * samples[index];
+            }
+            errorEnergy = nearEnergy;
+        }
+
+        out.insert(out.end(), pcm, pcm + count * PCM16_BYTES);
+        m_blockNear += nearEnergy;
+        m_blockError += errorEnergy;
+    }
+
+    void AudioEchoCanceller::EndBlock()
+    {
+        // Envelopes of the microphone and of the reference without the applied delay
+        m_reference->Read(m_micPosition, m_block.data(), BLOCK_SAMPLES);
+        const float refEnergy = AudioSimd::DotProduct(m_block.data(), m_block.data(), BLOCK_SAMPLES);
+        const float micLog = logf(std::max(m_blockNear, ENVELOPE_FLOOR));
+        const float refLog = logf(std::max(refEnergy, ENVELOPE_FLOOR));
+        if (m_envelopeBlocks > 0) {
+            m_micEnvelope[m_envelopeBlocks % m_micEnvelope.size()] = micLog - m_lastMicLog;
+            m_refEnvelope[m_envelopeBlocks % m_refEnvelope.size()] = refLog - m_lastRefLog;
+        }
+        m_lastMicLog = micLog;
+        m_lastRefLog = refLog;
+        m_envelopeBlocks++;
+        if (m_envelopeBlocks > m_refEnvelope.size() && m_envelopeBlocks % DELAY_CHECK_BLOCKS == 0) {
+            EstimateDelay();
+        }
+
+        if (m_blockActive) {
+            m_activeFrames++;
+            if (!m_blockDoubleTalk) {
+                const float erleDb = 10.0f * log10f((m_blockNear + ENERGY_EPSILON) / (m_blockError + ENERGY_EPSILON));
+                m_erleDb += (erleDb - m_erleDb) * ERLE_WEIGHT;
+            }
+        }
+
+        m_frames++;
+        m_frameNsTotal += m_blockNs;
+        m_frameNsMax = std::max(m_frameNsMax, m_blockNs);
+
+        m_blockFill = 0;
+        m_blockNear = 0.0f;
+        m_blockError = 0.0f;
+        m_blockActive = false;
+        m_blockDoubleTalk = false;
+        m_blockNs = 0;
+    }
+
+    void AudioEchoCanceller::EstimateDelay()
+    {
+        const size_t newest = m_envelopeBlocks - 1;
+        const size_t micSize = m_micEnvelope.size();
+        const size_t refSize = m_refEnvelope.size();
+
+        float micNorm = 0.0f;
+        for (size_t block = 0; block < DELAY_WINDOW_BLOCKS; block++) {
+            const float mic = m_micEnvelope[(newest - block) % micSize];
+            micNorm += mic * mic;
+        }
+        if (micNorm <= 0.0f) {
+            return;
+        }
+
+        const size_t lockedLag = m_delaySamples / BLOCK_SAMPLES + 1;
+        float lockedCorrelation = 0.0f;
+        float bestCorrelation = 0.0f;
+        size_t bestLag = NO_LAG;
+        for (size_t lag = 0; lag <= m_maxLagBlocks; lag++) {
+            float product = 0.0f;
+            float refNorm = 0.0f;
+            for (size_t block = 0; block < DELAY_WINDOW_BLOCKS; block++) {
+                const float ref = m_refEnvelope[(newest - block - lag) % refSize];
+                product += m_micEnvelope[(newest - block) % micSize] * ref;
+                refNorm += ref * ref;
+            }
+            if (refNorm > 0.0f) {
+                const float correlation = product / sqrtf(micNorm * refNorm);
+                if (lag == lockedLag) {
+                    lockedCorrelation = correlation;
+                }
+                if (correlation > bestCorrelation) {
+                    bestCorrelation = correlation;
+                    bestLag = lag;
+                }
+            }
+        }
+        if (bestCorrelation < DELAY_MIN_CORRELATION || (m_delayLocked && bestCorrelation < lockedCorrelation + DELAY_SWITCH_MARGIN)) {
+            m_candidateLag = NO_LAG;
+            return;
+        }
+
+        // Two consecutive estimates must agree, the filter keeps one block ahead of the estimate as a guard and a
+        // move within that guard is not worth the reset
+        if (m_candidateLag != NO_LAG && std::max(m_candidateLag, bestLag) - std::min(m_candidateLag, bestLag) <= 1) {
+            const size_t delaySamples = (bestLag > 0 ? bestLag - 1 : 0) * BLOCK_SAMPLES;
+            const size_t moved = std::max(delaySamples, m_delaySamples) - std::min(delaySamples, m_delaySamples);
+            if (!m_delayLocked || moved > BLOCK_SAMPLES) {
+                XLOGD_INFO("Echo delay <%u ms> correlation <%.2f>", static_cast<uint32_t>(bestLag * BLOCK_SAMPLES * 1000 / m_config.sampleRateHz), bestCorrelation);
+                std::fill(m_weights.begin(), m_weights.end(), 0.0f);
+                m_delaySamples = delaySamples;
+                m_delayLocked = true;
+            }
+        }
+        m_candidateLag = bestLag;
+    }
+
+    void AudioEchoCanceller::Reset()
+    {
+        m_anchored = false;
+        m_doubleTalkHold = 0;
+        m_blockFill = 0;
+        m_blockNear = 0.0f;
+        m_blockError = 0.0f;
+        m_blockActive = false;
+        m_blockDoubleTalk = false;
+        m_blockNs = 0;
+        m_envelopeBlocks = 0;
+        m_lastMicLog = 0.0f;
+        m_lastRefLog = 0.0f;
+        m_candidateLag = NO_LAG;
+        std::fill(m_micEnvelope.begin(), m_micEnvelope.end(), 0.0f);
+        std::fill(m_refEnvelope.begin(), m_refEnvelope.end(), 0.0f);
+    }
+
+    AudioEchoCanceller::Stats AudioEchoCanceller::GetStats() const
+    {
+        Stats stats;
+        stats.frames = m_frames;
+        stats.activeFrames = m_activeFrames;
+        stats.erleDb = m_erleDb;
+        stats.delayMs = static_cast<uint32_t>(m_delaySamples * 1000 / m_config.sampleRateHz);
+        stats.delayLocked = m_delayLocked;
+        stats.frameUsAvg = m_frames > 0 ? static_cast<uint32_t>(m_frameNsTotal / m_frames / 1000) : 0;
+        stats.frameUsMax = static_cast<uint32_t>(m_frameNsMax / 1000);
+        stats.blockMs = static_cast<uint32_t>(BLOCK_SAMPLES * 1000 / m_config.sampleRateHz);
+        return stats;
+    }
+
+} // namespace WPEFramework
@@ -0,0 +1,116 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include "AudioReference.h"
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace WPEFramework {
+
+    /// Acoustic echo canceller for 16-bit mono PCM against the media player output captured in an AudioReference.
+    /// A time domain NLMS filter covers the configured echo tail. Adaptation is frozen during double talk (Geigel
+    /// detector) and the filter is skipped while the reference has been silent for the whole tail. The bulk delay
+    /// between playback and capture is estimated by correlating the log energy envelopes of the microphone and the
+    /// reference over 4 ms blocks. The filter is reset whenever the estimate moves. The microphone timeline is
+    /// anchored to the steady clock on the earliest arrival of the session. Adds no latency.
+    /// Not thread safe, it is owned and driven by the SDS writer thread.
+    class AudioEchoCanceller {
+    public:
+        struct Config {
+            uint32_t sampleRateHz;
+            uint32_t tailMs;          ///< Echo path length covered by the adaptive filter
+            uint32_t maxDelayMs;      ///< Largest bulk delay searched between playback and capture
+        };
+
+        struct Stats {
+            uint64_t frames;          ///< Blocks processed
+            uint64_t activeFrames;    ///< Blocks processed with an active reference
+            float erleDb;             ///< Smoothed echo return loss enhancement
+            uint32_t delayMs;         ///< Bulk delay applied to the reference
+            bool delayLocked;         ///< The delay has been estimated at least once
+            uint32_t frameUsAvg;
+            uint32_t frameUsMax;
+            uint32_t blockMs;         ///< Audio per block, the real time budget of one block
+        };
+
+        static std::unique_ptr<AudioEchoCanceller> create(const Config& config, std::shared_ptr<AudioReference> reference);
+
+        AudioEchoCanceller(const AudioEchoCanceller&) = delete;
+        AudioEchoCanceller& operator=(const AudioEchoCanceller&) = delete;
+        ~AudioEchoCanceller() = default;
+
+        /// Appends the echo cancelled audio to out, arrivalNs is the steady clock time the audio was received
+        void Process(const uint8_t data[], const size_t length, const uint64_t arrivalNs, std::vector<uint8_t>& out);
+
+        /// Starts a new session, the filter and the delay estimate are kept
+        void Reset();
+
+        Stats GetStats() const;
+
+    private:
+        AudioEchoCanceller(const Config& config, std::shared_ptr<AudioReference> reference, const size_t taps, const size_t maxLagBlocks);
+
+        void Cancel(const int16_t samples[], const size_t count, std::vector<uint8_t>& out);
+        void EndBlock();
+        void EstimateDelay();
+
+    private:
+        const Config m_config;
+        std::shared_ptr<AudioReference> m_reference;
+        const size_t m_taps;
+        const size_t m_maxLagBlocks;
+        std::vector<float> m_weights;       ///< Reversed so a window of the reference lines up for the dot product
+        std::vector<float> m_far;
+        std::vector<float> m_near;
+        std::vector<float> m_error;
+        std::vector<float> m_block;
+        std::vector<int16_t> m_pcm;
+        uint64_t m_micPosition;
+        bool m_anchored;
+        size_t m_delaySamples;
+        size_t m_doubleTalkHold;
+        size_t m_blockFill;
+        float m_blockNear;
+        float m_blockError;
+        bool m_blockActive;
+        bool m_blockDoubleTalk;
+        uint64_t m_blockNs;
+        // Log energy derivative rings indexed by block count, the reference keeps the extra lags searched
+        std::vector<float> m_micEnvelope;
+        std::vector<float> m_refEnvelope;
+        size_t m_envelopeBlocks;
+        float m_lastMicLog;
+        float m_lastRefLog;
+        size_t m_candidateLag;
+        bool m_delayLocked;
+        uint64_t m_frames;
+        uint64_t m_activeFrames;
+        float m_erleDb;
+        uint64_t m_frameNsTotal;
+        uint64_t m_frameNsMax;
+    };
+
+} // namespace WPEFramework
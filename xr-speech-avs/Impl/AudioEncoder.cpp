@@ -0,0 +1,169 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioEncoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace WPEFramework {
+
+#if defined(OPUS_SUPPORT)
+
+    std::unique_ptr<AudioEncoder> AudioEncoder::create(const Config& config)
+    {
+        if (config.frameMs == 0 || config.bitRate == 0) {
+            XLOGD_ERROR("Invalid opus encoder configuration");
+            return nullptr;
+        }
+
+        int error = OPUS_OK;
+        OpusEncoder* encoder = opus_encoder_create(config.sampleRateHz, 1, OPUS_APPLICATION_VOIP, &error);
+        if (encoder == nullptr || error != OPUS_OK) {
+            XLOGD_ERROR("Failed to create opus encoder <%s>", opus_strerror(error));
+            return nullptr;
+        }
+
+        if (opus_encoder_ctl(encoder, OPUS_SET_BITRATE(config.bitRate)) != OPUS_OK ||
+            opus_encoder_ctl(encoder, OPUS_SET_VBR(0)) != OPUS_OK ||
+            opus_encoder_ctl(encoder, OPUS_SET_COMPLEXITY(config.complexity)) != OPUS_OK ||
+            opus_encoder_ctl(encoder, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE)) != OPUS_OK) {
+            XLOGD_ERROR("Failed to configure opus encoder");
+            opus_encoder_destroy(encoder);
+            return nullptr;
+        }
+
+        return std::unique_ptr<AudioEncoder>(new AudioEncoder(config, encoder));
+    }
+
+    AudioEncoder::AudioEncoder(const Config& config, OpusEncoder* encoder)
+        : m_encoder{ encoder }
+        , m_config(config)
+        , m_frameSamples{ static_cast<size_t>(config.sampleRateHz) * config.frameMs / 1000 }
+        , m_packetBytes{ static_cast<size_t>(config.bitRate) * config.frameMs / 8000 }
+        , m_pending(m_frameSamples, 0)
+        , m_pendingSamples{ 0 }
+        , m_oddByte{ 0 }
+        , m_hasOddByte{ false }
+        , m_stats()
+    {
+    }
+
+    AudioEncoder::~AudioEncoder()
+    {
+        opus_encoder_destroy(m_encoder);
+    }
+
+    bool AudioEncoder::Encode(const uint8_t pcm[], const size_t length, std::vector<uint8_t>& out)
+    {
+        bool status = true;
+        size_t offset = 0;
+
+        m_stats.bytesIn += length;
+
+        if (m_hasOddByte && length > 0) {
+            const uint8_t bytes[2] = { m_oddByte, pcm[0] };
+            std::memcpy(&m_pending[m_pendingSamples++], bytes, sizeof(int16_t));
+            m_hasOddByte = false;
+            offset = 1;
+            if (m_pendingSamples == m_frameSamples) {
+                status = EncodeFrame(out) && status;
+            }
+        }
+
+        while (length - offset >= sizeof(int16_t)) {
+            const size_t samples = std::min((length - offset) / sizeof(int16_t), m_frameSamples - m_pendingSamples);
+            std::memcpy(&m_pending[m_pendingSamples], pcm + offset, samples * sizeof(int16_t));
+            m_pendingSamples += samples;
+            offset += samples * sizeof(int16_t);
+            if (m_pendingSamples == m_frameSamples) {
+                status = EncodeFrame(out) && status;
+            }
+        }
+
+        if (offset < length) {
+            m_oddByte = pcm[offset];
+            m_hasOddByte = true;
+        }
+        return status;
+    }
+
+    void AudioEncoder::Flush(std::vector<uint8_t>& out)
+    {
+        if (m_pendingSamples > 0) {
+            std::fill(m_pending.begin() + m_pendingSamples, m_pending.end(), 0);
+            m_pendingSamples = m_frameSamples;
+            EncodeFrame(out);
+        }
+        m_hasOddByte = false;
+        opus_encoder_ctl(m_encoder, OPUS_RESET_STATE);
+    }
+
+    bool AudioEncoder::EncodeFrame(std::vector<uint8_t>& out)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const size_t offset = out.size();
+
+        out.resize(offset + m_packetBytes);
+        const opus_int32 bytes = opus_encode(m_encoder, m_pending.data(), static_cast<int>(m_frameSamples), &out[offset], static_cast<opus_int32>(m_packetBytes));
+        m_pendingSamples = 0;
+        if (bytes < 0) {
+            XLOGD_ERROR("Opus encode failed <%s>", opus_strerror(bytes));
+            out.resize(offset);
+            return false;
+        }
+        out.resize(offset + bytes);
+
+        m_stats.frames++;
+        m_stats.bytesOut += bytes;
+        m_stats.encodeUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        return true;
+    }
+
+#else
+
+    std::unique_ptr<AudioEncoder> AudioEncoder::create(const Config&)
+    {
+        XLOGD_ERROR("Opus support is not compiled in");
+        return nullptr;
+    }
+
+    AudioEncoder::~AudioEncoder()
+    {
+    }
+
+    bool AudioEncoder::Encode(const uint8_t[], const size_t, std::vector<uint8_t>&)
+    {
+        return false;
+    }
+
+    void AudioEncoder::Flush(std::vector<uint8_t>&)
+    {
+    }
+
+#endif
+
+    void AudioEncoder::ResetStats()
+    {
+        m_stats = Stats();
+    }
+
+} // namespace WPEFramework
@@ -0,0 +1,90 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+#if defined(OPUS_SUPPORT)
+#include <opus.h>
+#endif
+
+namespace WPEFramework {
+
+    /// Encodes 16-bit mono PCM into constant bit rate Opus frames for upload, matching the OPUS format the AVS
+    /// recognize event accepts (16 kHz, 32 kbit/s CBR, 20 ms frames). PCM is accumulated until a whole frame is
+    /// available. Not thread safe, it is owned and driven by the SDS writer thread.
+    class AudioEncoder {
+    public:
+        struct Config {
+            uint32_t sampleRateHz;
+            uint32_t bitRate;
+            uint32_t frameMs;
+            int complexity;
+        };
+
+        struct Stats {
+            uint64_t frames;
+            uint64_t bytesIn;
+            uint64_t bytesOut;
+            uint64_t encodeUs;
+        };
+
+        /// Returns nullptr when Opus support is not compiled in or the encoder cannot be set up
+        static std::unique_ptr<AudioEncoder> create(const Config& config);
+
+        AudioEncoder(const AudioEncoder&) = delete;
+        AudioEncoder& operator=(const AudioEncoder&) = delete;
+        ~AudioEncoder();
+
+        /// Appends the complete encoded frames available after adding length bytes of PCM to out
+        bool Encode(const uint8_t pcm[], const size_t length, std::vector<uint8_t>& out);
+
+        /// Pads the pending partial frame with silence, encodes it and resets the codec state
+        void Flush(std::vector<uint8_t>& out);
+
+        /// Starts a new set of per utterance counters
+        void ResetStats();
+
+        Stats GetStats() const { return m_stats; }
+
+    private:
+#if defined(OPUS_SUPPORT)
+        AudioEncoder(const Config& config, OpusEncoder* encoder);
+
+        bool EncodeFrame(std::vector<uint8_t>& out);
+
+        OpusEncoder* m_encoder;
+#endif
+        const Config m_config;
+        const size_t m_frameSamples;
+        const size_t m_packetBytes;
+        std::vector<int16_t> m_pending;
+        size_t m_pendingSamples;
+        uint8_t m_oddByte;
+        bool m_hasOddByte;
+        Stats m_stats;
+    };
+
+} // namespace WPEFramework
@@ -0,0 +1,100 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioFft.h"
+#include "AudioSimd.h"
+
+#include <rdkx_logger.h>
+
+#include <algorithm>
+#include <math.h>
+
+namespace WPEFramework {
+
+    std::unique_ptr<AudioFft> AudioFft::create(const size_t size)
+    {
+        if (size < 4 || (size & (size - 1)) != 0) {
+            XLOGD_ERROR("Invalid fft size <%zu>", size);
+            return nullptr;
+        }
+        return std::unique_ptr<AudioFft>(new AudioFft(size));
+    }
+
+    AudioFft::AudioFft(const size_t size)
+        : m_size(size)
+        , m_bitReverse(size)
+        , m_twiddleRe(size)
+        , m_twiddleIm(size)
+    {
+        size_t bits = 0;
+        while ((static_cast<size_t>(1) << bits) < size) {
+            bits++;
+        }
+        for (size_t index = 0; index < size; index++) {
+            size_t reversed = 0;
+            for (size_t bit = 0; bit < bits; bit++) {
+                reversed |= ((index >> bit) & 1) << (bits - 1 - bit);
+            }
+            m_bitReverse[index] = reversed;
+        }
+
+        for (size_t half = 1; half < size; half *= 2) {
+            for (size_t index = 0; index < half; index++) {
+                const double angle = -M_PI * index / half;
+                m_twiddleRe[half + index] = static_cast<float>(cos(angle));
+                m_twiddleIm[half + index] = static_cast<float>(sin(angle));
+            }
+        }
+    }
+
+    void AudioFft::Transform(float re[], float im[]) const
+    {
+        for (size_t index = 0; index < m_size; index++) {
+            const size_t reversed = m_bitReverse[index];
+            if (reversed > index) {
+                std::swap(re[index], re[reversed]);
+                std::swap(im[index], im[reversed]);
+            }
+        }
+
+        for (size_t half = 1; half < m_size; half *= 2) {
+            for (size_t group = 0; group < m_size; group += 2 * half) {
+                AudioSimd::Butterflies(re + group, im + group, &m_twiddleRe[half], &m_twiddleIm[half], half);
+            }
+        }
+    }
+
+    void AudioFft::Forward(float re[], float im[]) const
+    {
+        Transform(re, im);
+    }
+
+    void AudioFft::Inverse(float re[], float im[]) const
+    {
+        // ifft(x) = conj(fft(conj(x))) / N, the conjugates are folded into swapping re and im
+        Transform(im, re);
+        const float scale = 1.0f / m_size;
+        for (size_t index = 0; index < m_size; index++) {
+            re[index] *= scale;
+            im[index] *= scale;
+        }
+    }
+
+} // namespace WPEFramework
@@ -0,0 +1,60 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <stddef.h>
+#include <vector>
+
+namespace WPEFramework {
+
+    /// In-place radix-2 complex FFT on split real/imaginary arrays. Twiddles and the bit reversal permutation are
+    /// computed once at creation, the transforms neither allocate nor branch on the data.
+    class AudioFft {
+    public:
+        /// size must be a power of two of at least 4
+        static std::unique_ptr<AudioFft> create(const size_t size);
+
+        AudioFft(const AudioFft&) = delete;
+        AudioFft& operator=(const AudioFft&) = delete;
+        ~AudioFft() = default;
+
+        void Forward(float re[], float im[]) const;
+
+        /// Inverse transform including the 1/size scaling
+        void Inverse(float re[], float im[]) const;
+
+        size_t Size() const { return m_size; }
+
+    private:
+        AudioFft(const size_t size);
+
+        void Transform(float re[], float im[]) const;
+
+    private:
+        const size_t m_size;
+        std::vector<size_t> m_bitReverse;
+        // Twiddles of the stage with half size h start at offset h
+        std::vector<float> m_twiddleRe;
+        std::vector<float> m_twiddleIm;
+    };
+
+} // namespace WPEFramework
@@ -0,0 +1,174 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioFormatConverter.h"
+#include "AudioSimd.h"
+#include "CompatibleAudioFormat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace WPEFramework {
+
+    // Filter taps per polyphase branch for every multiple of decimation
+    static const uint32_t TAPS_PER_DECIMATION = 16;
+    // Pass band edge relative to the output Nyquist frequency
+    static const double CUTOFF_RATIO = 0.9;
+
+    static uint32_t GreatestCommonDivisor(uint32_t a, uint32_t b)
+    {
+        while (b != 0) {
+            const uint32_t t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+
+    std::unique_ptr<AudioFormatConverter> AudioFormatConverter::create(const uint32_t inputRateHz, const uint32_t inputChannels, const uint32_t outputRateHz)
+    {
+        if (!AudioFormatCompatibility::IsConvertible(inputRateHz, inputChannels) || outputRateHz == 0) {
+            return nullptr;
+        }
+
+        const uint32_t divisor = GreatestCommonDivisor(inputRateHz, outputRateHz);
+        const uint32_t up = outputRateHz / divisor;
+        const uint32_t down = inputRateHz / divisor;
+        const uint32_t taps = (up == down) ? AudioSimd::AUDIO_SIMD_WIDTH : TAPS_PER_DECIMATION * ((down + up - 1) / up);
+
+        return std::unique_ptr<AudioFormatConverter>(new AudioFormatConverter(inputRateHz, inputChannels, up, down, taps));
+    }
+
+    AudioFormatConverter::AudioFormatConverter(const uint32_t inputRateHz, const uint32_t inputChannels, const uint32_t up, const uint32_t down, const uint32_t taps)
+        : m_inputRateHz{ inputRateHz }
+        , m_inputChannels{ inputChannels }
+        , m_up{ up }
+        , m_down{ down }
+        , m_taps{ taps }
+        , m_coefficients(static_cast<size_t>(up) * taps, 0.0f)
+        , m_position{ 0 }
+        , m_carryLength{ 0 }
+    {
+        if (up == down) {
+            // Same rate, a unit impulse keeps the shared code path
+            m_coefficients[taps - 1] = 1.0f;
+        } else {
+            // Blackman windowed sinc prototype at the upsampled rate, split into polyphase branches
+            const size_t length = static_cast<size_t>(up) * taps;
+            const double cutoff = CUTOFF_RATIO * 0.5 / std::max(up, down);
+            const double center = (length - 1) / 2.0;
+            for (size_t n = 0; n < length; n++) {
+                const double x = n - center;
+                const double sinc = (x == 0.0) ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+                const double window = 0.42 - 0.5 * std::cos(2.0 * M_PI * n / (length - 1)) + 0.08 * std::cos(4.0 * M_PI * n / (length - 1));
+                const size_t phase = n % up;
+                const size_t tap = n / up;
+                m_coefficients[phase * taps + (taps - 1 - tap)] = static_cast<float>(sinc * window * up);
+            }
+        }
+        Reset();
+    }
+
+    void AudioFormatConverter::Reset()
+    {
+        m_history.assign(m_taps - 1, 0.0f);
+        m_position = static_cast<uint64_t>(m_taps - 1) * m_up;
+        m_carryLength = 0;
+    }
+
+    void AudioFormatConverter::Process(const uint8_t data[], const size_t length, std::vector<uint8_t>& out)
+    {
+        const size_t frameBytes = m_inputChannels * sizeof(int16_t);
+        const float scale = 1.0f / m_inputChannels;
+        size_t offset = 0;
+
+        if (m_carryLength > 0) {
+            const size_t needed = std::min(frameBytes - m_carryLength, length);
+            std::memcpy(m_carry + m_carryLength, data, needed);
+            m_carryLength += needed;
+            offset = needed;
+            if (m_carryLength < frameBytes) {
+                return;
+            }
+            float sum = 0.0f;
+            for (uint32_t channel = 0; channel < m_inputChannels; channel++) {
+                int16_t sample;
+                std::memcpy(&sample, m_carry + channel * sizeof(int16_t), sizeof(sample));
+                sum += sample;
+            }
+            m_history.push_back(sum * scale);
+            m_carryLength = 0;
+        }
+
+        const size_t frames = (length - offset) / frameBytes;
+        const size_t base = m_history.size();
+        m_history.resize(base + frames);
+        float* mono = &m_history[base];
+        if (m_inputChannels == 1) {
+            for (size_t frame = 0; frame < frames; frame++) {
+                int16_t sample;
+                std::memcpy(&sample, data + offset + frame * frameBytes, sizeof(sample));
+                mono[frame] = sample;
+            }
+        } else {
+            for (size_t frame = 0; frame < frames; frame++) {
+                const uint8_t* in = data + offset + frame * frameBytes;
+                float sum = 0.0f;
+                for (uint32_t channel = 0; channel < m_inputChannels; channel++) {
+                    int16_t sample;
+                    std::memcpy(&sample, in + channel * sizeof(int16_t), sizeof(sample));
+                    sum += sample;
+                }
+                mono[frame] = sum * scale;
+            }
+        }
+
+        offset += frames * frameBytes;
+        m_carryLength = length - offset;
+        std::memcpy(m_carry, data + offset, m_carryLength);
+
+        Resample(out);
+    }
+
+    void AudioFormatConverter::Resample(std::vector<uint8_t>& out)
+    {
+        const uint64_t available = m_history.size();
+        m_output.clear();
+        while (m_position / m_up < available) {
+            const uint64_t index = m_position / m_up;
+            const uint32_t phase = static_cast<uint32_t>(m_position % m_up);
+            m_output.push_back(AudioSimd::DotProduct(&m_coefficients[static_cast<size_t>(phase) * m_taps], &m_history[index - (m_taps - 1)], m_taps));
+            m_position += m_down;
+        }
+
+        const size_t offset = out.size();
+        out.resize(offset + m_output.size() * sizeof(int16_t));
+        AudioSimd::FloatToPcm16(m_output.data(), reinterpret_cast<int16_t*>(&out[offset]), m_output.size());
+
+        // Keep only the history the next output sample still needs
+        const uint64_t consumed = std::min<uint64_t>(m_position / m_up - (m_taps - 1), available);
+        if (consumed > 0) {
+            m_history.erase(m_history.begin(), m_history.begin() + consumed);
+            m_position -= consumed * m_up;
+        }
+    }
+
+} // namespace WPEFramework
@@ -0,0 +1,74 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace WPEFramework {
+
+    /// Converts interleaved 16-bit little endian PCM with 1-4 channels at any rate accepted by
+    /// AudioFormatCompatibility::IsConvertible into 16 kHz mono. Channels are averaged, then a polyphase FIR
+    /// resampler with vectorized dot products brings the rate to the output rate.
+    /// Not thread safe, it is owned and driven by the SDS writer thread.
+    class AudioFormatConverter {
+    public:
+        static std::unique_ptr<AudioFormatConverter> create(const uint32_t inputRateHz, const uint32_t inputChannels, const uint32_t outputRateHz);
+
+        AudioFormatConverter(const AudioFormatConverter&) = delete;
+        AudioFormatConverter& operator=(const AudioFormatConverter&) = delete;
+        ~AudioFormatConverter() = default;
+
+        /// Converts length bytes of input and appends the output samples to out. Partial sample frames are kept
+        /// for the next call.
+        void Process(const uint8_t data[], const size_t length, std::vector<uint8_t>& out);
+
+        /// Forgets the filter history, used between sessions
+        void Reset();
+
+        uint32_t InputRateHz() const { return m_inputRateHz; }
+        uint32_t InputChannels() const { return m_inputChannels; }
+
+    private:
+        AudioFormatConverter(const uint32_t inputRateHz, const uint32_t inputChannels, const uint32_t up, const uint32_t down, const uint32_t taps);
+
+        void Resample(std::vector<uint8_t>& out);
+
+    private:
+        const uint32_t m_inputRateHz;
+        const uint32_t m_inputChannels;
+        const uint32_t m_up;
+        const uint32_t m_down;
+        const uint32_t m_taps;
+
+        // Phase major, each phase time reversed so an output sample is one contiguous dot product
+        std::vector<float> m_coefficients;
+        std::vector<float> m_history;
+        std::vector<float> m_output;
+        uint64_t m_position;
+        uint8_t m_carry[8];
+        size_t m_carryLength;
+    };
+
+} // namespace WPEFramework
@@ -0,0 +1,183 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioJitterBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace WPEFramework {
+
+    // Jitter buffer capacity in multiples of the maximum delay
+    static const uint32_t CAPACITY_IN_MAX_DELAYS = 4;
+    // Target delay in multiples of the jitter estimate, on top of one frame
+    static const double JITTER_MULTIPLIER = 4.0;
+    static const uint64_t NS_PER_MS = 1000000ULL;
+    static const uint64_t NS_PER_SECOND = 1000000000ULL;
+
+    std::unique_ptr<AudioJitterBuffer> AudioJitterBuffer::create(const Config& config)
+    {
+        if (config.bytesPerSecond == 0 || config.frameMs == 0) {
+            XLOGD_ERROR("Invalid jitter buffer rate or frame size");
+            return nullptr;
+        }
+        if (config.minDelayMs > config.maxDelayMs) {
+            XLOGD_ERROR("Invalid jitter buffer delay range <%u-%u>", config.minDelayMs, config.maxDelayMs);
+            return nullptr;
+        }
+        return std::unique_ptr<AudioJitterBuffer>(new AudioJitterBuffer(config));
+    }
+
+    AudioJitterBuffer::AudioJitterBuffer(const Config& config)
+        : m_config(config)
+        , m_frameBytes{ (static_cast<size_t>(config.bytesPerSecond) * config.frameMs / 1000) & ~static_cast<size_t>(1) }
+        , m_ring(std::max<size_t>(static_cast<size_t>(config.bytesPerSecond) * config.maxDelayMs / 1000 * CAPACITY_IN_MAX_DELAYS, config.bytesPerSecond))
+        , m_readPos{ 0 }
+        , m_buffered{ 0 }
+        , m_playing{ false }
+        , m_playoutStartNs{ 0 }
+        , m_framesSinceStart{ 0 }
+        , m_hasArrival{ false }
+        , m_lastArrivalNs{ 0 }
+        , m_lastArrivalBytes{ 0 }
+        , m_jitterNs{ 0.0 }
+        , m_targetDelayNs{ config.minDelayMs * NS_PER_MS }
+        , m_addedLatencyNsSum{ 0 }
+        , m_addedLatencyNsMax{ 0 }
+        , m_underruns{ 0 }
+        , m_overflows{ 0 }
+        , m_framesReleased{ 0 }
+    {
+        UpdateTargetDelay();
+    }
+
+    void AudioJitterBuffer::Reset()
+    {
+        m_readPos = 0;
+        m_buffered = 0;
+        m_playing = false;
+        m_framesSinceStart = 0;
+        m_hasArrival = false;
+    }
+
+    void AudioJitterBuffer::Push(const uint8_t data[], const size_t length, const uint64_t arrivalNs)
+    {
+        if (m_hasArrival) {
+            // Deviation of the actual arrival spacing from the audio duration delivered by the previous burst
+            const double transit = static_cast<double>(arrivalNs - m_lastArrivalNs) - static_cast<double>(BytesToNs(m_lastArrivalBytes));
+            m_jitterNs += (std::fabs(transit) - m_jitterNs) / 16.0;
+            UpdateTargetDelay();
+        }
+        m_hasArrival = true;
+        m_lastArrivalNs = arrivalNs;
+        m_lastArrivalBytes = length;
+
+        size_t count = length;
+        if (count > m_ring.size() - m_buffered) {
+            // Keep the newest audio, the oldest is already late
+            m_overflows++;
+            if (count > m_ring.size()) {
+                data += count - m_ring.size();
+                count = m_ring.size();
+            }
+            const size_t drop = count - (m_ring.size() - m_buffered);
+            m_readPos = (m_readPos + drop) % m_ring.size();
+            m_buffered -= drop;
+        }
+
+        const size_t writePos = (m_readPos + m_buffered) % m_ring.size();
+        const size_t first = std::min(count, m_ring.size() - writePos);
+        std::memcpy(&m_ring[writePos], data, first);
+        std::memcpy(&m_ring[0], data + first, count - first);
+        m_buffered += count;
+    }
+
+    size_t AudioJitterBuffer::Pull(const uint64_t nowNs, uint8_t out[], const size_t outSize, const bool flush)
+    {
+        if (flush) {
+            m_playing = false;
+            return Read(out, std::min(outSize, m_buffered));
+        }
+
+        if (!m_playing) {
+            if (BytesToNs(m_buffered) < m_targetDelayNs) {
+                return 0;
+            }
+            m_playing = true;
+            m_playoutStartNs = nowNs;
+            m_framesSinceStart = 0;
+        }
+
+        const uint64_t framesDue = (nowNs - m_playoutStartNs) / (m_config.frameMs * NS_PER_MS) + 1;
+        size_t released = 0;
+        while (m_framesSinceStart < framesDue && released + m_frameBytes <= outSize) {
+            if (m_buffered < m_frameBytes) {
+                // Ran dry, rebuild the playout delay before releasing more audio
+                m_underruns++;
+                m_playing = false;
+                break;
+            }
+            const uint64_t latencyNs = BytesToNs(m_buffered);
+            m_addedLatencyNsSum += latencyNs;
+            m_addedLatencyNsMax = std::max(m_addedLatencyNsMax, latencyNs);
+            released += Read(out + released, m_frameBytes);
+            m_framesSinceStart++;
+            m_framesReleased++;
+        }
+        return released;
+    }
+
+    AudioJitterBuffer::Stats AudioJitterBuffer::GetStats() const
+    {
+        Stats stats;
+        stats.targetDelayMs = static_cast<uint32_t>(m_targetDelayNs / NS_PER_MS);
+        stats.jitterMs = static_cast<uint32_t>(m_jitterNs / NS_PER_MS);
+        stats.bufferedMs = static_cast<uint32_t>(BytesToNs(m_buffered) / NS_PER_MS);
+        stats.addedLatencyMsAvg = static_cast<uint32_t>(m_framesReleased ? m_addedLatencyNsSum / m_framesReleased / NS_PER_MS : 0);
+        stats.addedLatencyMsMax = static_cast<uint32_t>(m_addedLatencyNsMax / NS_PER_MS);
+        stats.underruns = m_underruns;
+        stats.overflows = m_overflows;
+        stats.framesReleased = m_framesReleased;
+        return stats;
+    }
+
+    uint64_t AudioJitterBuffer::BytesToNs(const uint64_t bytes) const
+    {
+        return bytes * NS_PER_SECOND / m_config.bytesPerSecond;
+    }
+
+    void AudioJitterBuffer::UpdateTargetDelay()
+    {
+        const uint64_t target = m_config.frameMs * NS_PER_MS + static_cast<uint64_t>(JITTER_MULTIPLIER * m_jitterNs);
+        m_targetDelayNs = std::min(std::max(target, m_config.minDelayMs * NS_PER_MS), m_config.maxDelayMs * NS_PER_MS);
+    }
+
+    size_t AudioJitterBuffer::Read(uint8_t out[], const size_t length)
+    {
+        const size_t first = std::min(length, m_ring.size() - m_readPos);
+        std::memcpy(out, &m_ring[m_readPos], first);
+        std::memcpy(out + first, &m_ring[0], length - first);
+        m_readPos = (m_readPos + length) % m_ring.size();
+        m_buffered -= length;
+        return length;
+    }
+
+} // namespace WPEFramework
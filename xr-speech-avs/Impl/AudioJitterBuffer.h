@@ -0,0 +1,106 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace WPEFramework {
+
+    /// Adaptive jitter buffer that smooths bursty voice delivery into a steady frame cadence in front of the SDS writer.
+    /// The playout delay follows the inter-arrival jitter estimate (RFC 3550 style) bounded by the configured limits.
+    /// Not thread safe, it is owned and driven by the SDS writer thread.
+    class AudioJitterBuffer {
+    public:
+        struct Config {
+            uint32_t bytesPerSecond;
+            uint32_t frameMs;
+            uint32_t minDelayMs;
+            uint32_t maxDelayMs;
+        };
+
+        struct Stats {
+            uint32_t targetDelayMs;
+            uint32_t jitterMs;
+            uint32_t bufferedMs;
+            uint32_t addedLatencyMsAvg;
+            uint32_t addedLatencyMsMax;
+            uint64_t underruns;
+            uint64_t overflows;
+            uint64_t framesReleased;
+        };
+
+        static std::unique_ptr<AudioJitterBuffer> create(const Config& config);
+
+        AudioJitterBuffer(const AudioJitterBuffer&) = delete;
+        AudioJitterBuffer& operator=(const AudioJitterBuffer&) = delete;
+        ~AudioJitterBuffer() = default;
+
+        /// Drops all buffered audio and restarts the prebuffering phase, the jitter estimate is kept
+        void Reset();
+
+        /// Adds audio that arrived at arrivalNs
+        void Push(const uint8_t data[], const size_t length, const uint64_t arrivalNs);
+
+        /// Copies the audio due for playout at nowNs into out and returns its length in bytes.
+        /// When flush is set everything buffered is released regardless of the cadence.
+        size_t Pull(const uint64_t nowNs, uint8_t out[], const size_t outSize, const bool flush);
+
+        /// Frame cadence, used by the owner to pace its wakeups
+        uint32_t FrameMs() const { return m_config.frameMs; }
+
+        Stats GetStats() const;
+
+    private:
+        AudioJitterBuffer(const Config& config);
+
+        uint64_t BytesToNs(const uint64_t bytes) const;
+        void UpdateTargetDelay();
+        size_t Read(uint8_t out[], const size_t length);
+
+    private:
+        const Config m_config;
+        const size_t m_frameBytes;
+        std::vector<uint8_t> m_ring;
+        size_t m_readPos;
+        size_t m_buffered;
+
+        bool m_playing;
+        uint64_t m_playoutStartNs;
+        uint64_t m_framesSinceStart;
+
+        bool m_hasArrival;
+        uint64_t m_lastArrivalNs;
+        uint64_t m_lastArrivalBytes;
+        double m_jitterNs;
+        uint64_t m_targetDelayNs;
+
+        uint64_t m_addedLatencyNsSum;
+        uint64_t m_addedLatencyNsMax;
+        uint64_t m_underruns;
+        uint64_t m_overflows;
+        uint64_t m_framesReleased;
+    };
+
+} // namespace WPEFramework
@@ -0,0 +1,94 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioLatencyHistogram.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace WPEFramework {
+
+    static const uint32_t BUCKETS_PER_OCTAVE = 8;
+    static const uint32_t OCTAVES = 24;
+
+    std::unique_ptr<AudioLatencyHistogram> AudioLatencyHistogram::create()
+    {
+        return std::unique_ptr<AudioLatencyHistogram>(new AudioLatencyHistogram());
+    }
+
+    AudioLatencyHistogram::AudioLatencyHistogram()
+        : m_buckets(BUCKETS_PER_OCTAVE * OCTAVES + 1, 0)
+        , m_count(0)
+        , m_maxNs(0)
+    {
+    }
+
+    void AudioLatencyHistogram::Record(const uint64_t latencyNs)
+    {
+        const double latencyUs = latencyNs / 1000.0;
+        size_t bucket = 0;
+        if (latencyUs > 1.0) {
+            bucket = std::min(static_cast<size_t>(ceil(log2(latencyUs) * BUCKETS_PER_OCTAVE)), m_buckets.size() - 1);
+        }
+        m_buckets[bucket]++;
+        m_count++;
+        m_maxNs = std::max(m_maxNs, latencyNs);
+    }
+
+    void AudioLatencyHistogram::Reset()
+    {
+        std::fill(m_buckets.begin(), m_buckets.end(), 0);
+        m_count = 0;
+        m_maxNs = 0;
+    }
+
+    uint32_t AudioLatencyHistogram::Percentile(const uint32_t percent) const
+    {
+        if (m_count == 0) {
+            return 0;
+        }
+        const uint64_t rank = (m_count * percent + 99) / 100;
+        uint64_t cumulative = 0;
+        for (size_t bucket = 0; bucket < m_buckets.size(); bucket++) {
+            cumulative += m_buckets[bucket];
+            if (cumulative >= rank) {
+                // The last bucket collects everything from 2^24 us up and has no bound of its own
+                if (bucket == m_buckets.size() - 1) {
+                    return static_cast<uint32_t>(m_maxNs / 1000);
+                }
+                const double boundUs = pow(2.0, static_cast<double>(bucket) / BUCKETS_PER_OCTAVE);
+                return static_cast<uint32_t>(std::min(boundUs, m_maxNs / 1000.0));
+            }
+        }
+        return static_cast<uint32_t>(m_maxNs / 1000);
+    }
+
+    AudioLatencyHistogram::Stats AudioLatencyHistogram::GetStats() const
+    {
+        Stats stats;
+        stats.count = m_count;
+        stats.p50Us = Percentile(50);
+        stats.p95Us = Percentile(95);
+        stats.p99Us = Percentile(99);
+        stats.maxUs = static_cast<uint32_t>(m_maxNs / 1000);
+        return stats;
+    }
+
+} // namespace WPEFramework
@@ -0,0 +1,64 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace WPEFramework {
+
+    /// Latency histogram with logarithmic buckets, eight per octave from 1 us to about 16 s (9% resolution).
+    /// Percentiles report the upper bound of the bucket they fall in. Not thread safe.
+    class AudioLatencyHistogram {
+    public:
+        struct Stats {
+            uint64_t count;
+            uint32_t p50Us;
+            uint32_t p95Us;
+            uint32_t p99Us;
+            uint32_t maxUs;
+        };
+
+        static std::unique_ptr<AudioLatencyHistogram> create();
+
+        AudioLatencyHistogram(const AudioLatencyHistogram&) = delete;
+        AudioLatencyHistogram& operator=(const AudioLatencyHistogram&) = delete;
+        ~AudioLatencyHistogram() = default;
+
+        void Record(const uint64_t latencyNs);
+        void Reset();
+        Stats GetStats() const;
+
+    private:
+        AudioLatencyHistogram();
+
+        uint32_t Percentile(const uint32_t percent) const;
+
+    private:
+        std::vector<uint64_t> m_buckets;
+        uint64_t m_count;
+        uint64_t m_maxNs;
+    };
+
+} // namespace WPEFramework
@@ -0,0 +1,105 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioLevelMeter.h"
+#include "AudioSimd.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace WPEFramework {
+
+    static const int16_t CLIP_LEVEL = 32767;
+    static const float FULL_SCALE = 32768.0f;
+    // Reported for digital silence, below the 16-bit noise floor
+    static const float LEVEL_FLOOR_DBFS = -96.0f;
+
+    static float PowerToDbfs(const double power)
+    {
+        if (power <= 0.0) {
+            return LEVEL_FLOOR_DBFS;
+        }
+        return std::max(static_cast<float>(10.0 * log10(power / (FULL_SCALE * FULL_SCALE))), LEVEL_FLOOR_DBFS);
+    }
+
+    std::unique_ptr<AudioLevelMeter> AudioLevelMeter::create()
+    {
+        return std::unique_ptr<AudioLevelMeter>(new AudioLevelMeter());
+    }
+
+    AudioLevelMeter::AudioLevelMeter()
+        : m_stats()
+        , m_sumSquares(0)
+        , m_samples(0)
+    {
+        Reset();
+    }
+
+    void AudioLevelMeter::Process(const int16_t samples[], const size_t count)
+    {
+        if (count == 0) {
+            return;
+        }
+
+        const uint64_t sumSquares = AudioSimd::SumSquares(samples, count);
+        uint32_t clips;
+        const uint16_t peak = AudioSimd::PeakMagnitude(samples, count, CLIP_LEVEL, clips);
+
+        Level& level = m_stats.last;
+        level.rmsDbfs = PowerToDbfs(static_cast<double>(sumSquares) / count);
+        level.peakDbfs = PowerToDbfs(static_cast<double>(peak) * peak);
+        level.clips = clips;
+
+        m_sumSquares += sumSquares;
+        m_samples += count;
+        if (m_stats.frames == 0) {
+            m_stats.rmsDbfsMin = level.rmsDbfs;
+            m_stats.rmsDbfsMax = level.rmsDbfs;
+            m_stats.peakDbfs = level.peakDbfs;
+        } else {
+            m_stats.rmsDbfsMin = std::min(m_stats.rmsDbfsMin, level.rmsDbfs);
+            m_stats.rmsDbfsMax = std::max(m_stats.rmsDbfsMax, level.rmsDbfs);
+            m_stats.peakDbfs = std::max(m_stats.peakDbfs, level.peakDbfs);
+        }
+        m_stats.rmsDbfsMean = PowerToDbfs(static_cast<double>(m_sumSquares) / m_samples);
+        m_stats.clips += clips;
+        m_stats.frames++;
+
+        m_snapshot.Store(m_stats);
+    }
+
+    void AudioLevelMeter::Reset()
+    {
+        m_stats.frames = 0;
+        m_stats.rmsDbfsMin = LEVEL_FLOOR_DBFS;
+        m_stats.rmsDbfsMean = LEVEL_FLOOR_DBFS;
+        m_stats.rmsDbfsMax = LEVEL_FLOOR_DBFS;
+        m_stats.peakDbfs = LEVEL_FLOOR_DBFS;
+        m_stats.clips = 0;
+        m_stats.last.rmsDbfs = LEVEL_FLOOR_DBFS;
+        m_stats.last.peakDbfs = LEVEL_FLOOR_DBFS;
+        m_stats.last.clips = 0;
+        m_sumSquares = 0;
+        m_samples = 0;
+
+        m_snapshot.Store(m_stats);
+    }
+
+} // namespace WPEFramework
@@ -0,0 +1,78 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include "AudioSnapshot.h"
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <stdint.h>
+
+namespace WPEFramework {
+
+    /// Input level metering of 16-bit PCM frames as they are received: RMS, peak and clipped samples per frame,
+    /// rolled up into minimum, mean and maximum levels per session. Levels are in dB relative to full scale.
+    /// Process and Reset are driven by the SDS writer thread, GetStats is lock-free and may be called from any
+    /// thread at any rate.
+    class AudioLevelMeter {
+    public:
+        struct Level {
+            float rmsDbfs;
+            float peakDbfs;
+            uint32_t clips;           ///< Samples at full scale
+        };
+
+        struct Stats {
+            uint64_t frames;          ///< Frames metered in the current session
+            float rmsDbfsMin;
+            float rmsDbfsMean;        ///< RMS over all samples of the session
+            float rmsDbfsMax;
+            float peakDbfs;
+            uint64_t clips;
+            Level last;               ///< Most recent frame
+        };
+
+        static std::unique_ptr<AudioLevelMeter> create();
+
+        AudioLevelMeter(const AudioLevelMeter&) = delete;
+        AudioLevelMeter& operator=(const AudioLevelMeter&) = delete;
+        ~AudioLevelMeter() = default;
+
+        /// Meters one received frame and publishes the result
+        void Process(const int16_t samples[], const size_t count);
+
+        /// Starts a new session
+        void Reset();
+
+        Stats GetStats() const { return m_snapshot.Load(); }
+
+    private:
+        AudioLevelMeter();
+
+    private:
+        AudioSnapshot<Stats> m_snapshot;
+        Stats m_stats;
+        uint64_t m_sumSquares;
+        uint64_t m_samples;
+    };
+
+} // namespace WPEFramework
@@ -0,0 +1,201 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioNoiseSuppressor.h"
+#include "AudioSimd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+
+namespace WPEFramework {
+
+    static const size_t FFT_SIZE = 256;
+    static const uint32_t PCM16_BYTES = 2;
+    // The first frames are assumed to be noise and averaged into the initial estimate
+    static const uint32_t NOISE_INIT_FRAMES = 10;
+    // Minimum tracking: follows the smoothed power down at once, rises by at most ~3 dB/s at 8 ms hops
+    static const float POWER_SMOOTHING = 0.7f;
+    static const float NOISE_RISE = 1.006f;
+    // Decision-directed a priori SNR weight
+    static const float PRIORI_WEIGHT = 0.98f;
+    static const float POWER_EPSILON = 1e-3f;
+    // Frames averaged when comparing against the CPU budget
+    static const double BUDGET_AVG_WEIGHT = 1.0 / 32;
+
+    std::unique_ptr<AudioNoiseSuppressor> AudioNoiseSuppressor::create(const Config& config)
+    {
+        if (config.sampleRateHz == 0 || config.suppressionDb == 0) {
+            XLOGD_ERROR("Invalid noise suppressor configuration");
+            return nullptr;
+        }
+        std::unique_ptr<AudioFft> fft = AudioFft::create(FFT_SIZE);
+        if (!fft) {
+            return nullptr;
+        }
+        return std::unique_ptr<AudioNoiseSuppressor>(new AudioNoiseSuppressor(config, std::move(fft)));
+    }
+
+    AudioNoiseSuppressor::AudioNoiseSuppressor(const Config& config, std::unique_ptr<AudioFft> fft)
+        : m_config(config)
+        , m_fft(std::move(fft))
+        , m_size(FFT_SIZE)
+        , m_hop(FFT_SIZE / 2)
+        , m_bins(FFT_SIZE / 2 + 1)
+        , m_gainFloor(powf(10.0f, -static_cast<float>(config.suppressionDb) / 20.0f))
+        , m_window(FFT_SIZE)
+        , m_input(FFT_SIZE, 0.0f)
+        , m_overlap(FFT_SIZE / 2, 0.0f)
+        , m_re(FFT_SIZE)
+        , m_im(FFT_SIZE)
+        , m_power(FFT_SIZE)
+        , m_smoothedPower(FFT_SIZE, 0.0f)
+        , m_noise(FFT_SIZE, 0.0f)
+        , m_gain(FFT_SIZE, 1.0f)
+        , m_previousPost(FFT_SIZE, 1.0f)
+        , m_pcm(FFT_SIZE / 2)
+        , m_pending(0)
+        , m_outstanding(0)
+        , m_noiseFrames(0)
+        , m_bypassed(false)
+        , m_frames(0)
+        , m_frameNsTotal(0)
+        , m_frameNsMax(0)
+        , m_frameNsAvg(0.0)
+    {
+        // sqrt-Hann on analysis and synthesis sums to one at 50% overlap
+        for (size_t index = 0; index < m_size; index++) {
+            m_window[index] = static_cast<float>(sin(M_PI * index / m_size));
+        }
+    }
+
+    void AudioNoiseSuppressor::Process(const uint8_t data[], const size_t length, std::vector<uint8_t>& out)
+    {
+        const int16_t* samples = reinterpret_cast<const int16_t*>(data);
+        const size_t count = length / PCM16_BYTES;
+
+        m_outstanding += count;
+        for (size_t index = 0; index < count; index++) {
+            m_input[m_hop + m_pending++] = samples[index];
+            if (m_pending == m_hop) {
+                ProcessHop(out, m_hop);
+            }
+        }
+    }
+
+    void AudioNoiseSuppressor::Flush(std::vector<uint8_t>& out)
+    {
+        // Zero padded hops push the held samples out, only the real ones are emitted
+        while (m_outstanding > 0) {
+            std::fill(m_input.begin() + m_hop + m_pending, m_input.end(), 0.0f);
+            ProcessHop(out, std::min(m_outstanding, m_hop));
+        }
+
+        std::fill(m_input.begin(), m_input.end(), 0.0f);
+        std::fill(m_overlap.begin(), m_overlap.end(), 0.0f);
+        m_pending = 0;
+        m_bypassed = false;
+    }
+
+    void AudioNoiseSuppressor::ProcessHop(std::vector<uint8_t>& out, const size_t outSamples)
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        if (m_bypassed) {
+            // The oldest hop of the input lines up with the output of the processed path
+            AudioSimd::FloatToPcm16(&m_input[0], m_pcm.data(), m_hop);
+        } else {
+            AudioSimd::Multiply(m_input.data(), m_window.data(), m_re.data(), m_size);
+            std::fill(m_im.begin(), m_im.end(), 0.0f);
+            m_fft->Forward(m_re.data(), m_im.data());
+            Suppress();
+            m_fft->Inverse(m_re.data(), m_im.data());
+            AudioSimd::Multiply(m_re.data(), m_window.data(), m_re.data(), m_size);
+
+            for (size_t index = 0; index < m_hop; index++) {
+                m_re[index] += m_overlap[index];
+            }
+            std::copy(m_re.begin() + m_hop, m_re.end(), m_overlap.begin());
+            AudioSimd::FloatToPcm16(m_re.data(), m_pcm.data(), m_hop);
+        }
+
+        const uint8_t* pcm = reinterpret_cast<const uint8_t*>(m_pcm.data());
+        out.insert(out.end(), pcm, pcm + outSamples * PCM16_BYTES);
+        m_outstanding -= outSamples;
+
+        std::copy(m_input.begin() + m_hop, m_input.end(), m_input.begin());
+        m_pending = 0;
+
+        const uint64_t frameNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        m_frames++;
+        m_frameNsTotal += frameNs;
+        m_frameNsMax = std::max(m_frameNsMax, frameNs);
+        m_frameNsAvg += (frameNs - m_frameNsAvg) * BUDGET_AVG_WEIGHT;
+        if (!m_bypassed && m_config.budgetUs > 0 && m_frames > NOISE_INIT_FRAMES && m_frameNsAvg > m_config.budgetUs * 1000.0) {
+            XLOGD_WARN("Noise suppression over budget <%u us>, bypassed for this session", static_cast<uint32_t>(m_frameNsAvg / 1000));
+            m_bypassed = true;
+        }
+    }
+
+    void AudioNoiseSuppressor::Suppress()
+    {
+        // Bins above Nyquist mirror the lower half, the kernels run over whole vectors
+        const size_t vectorBins = (m_bins + AudioSimd::AUDIO_SIMD_WIDTH - 1) & ~(AudioSimd::AUDIO_SIMD_WIDTH - 1);
+        AudioSimd::PowerSpectrum(m_re.data(), m_im.data(), m_power.data(), vectorBins);
+
+        if (m_noiseFrames < NOISE_INIT_FRAMES) {
+            m_noiseFrames++;
+            for (size_t bin = 0; bin < m_bins; bin++) {
+                m_smoothedPower[bin] = m_power[bin];
+                m_noise[bin] += (m_power[bin] - m_noise[bin]) / m_noiseFrames;
+            }
+            return;
+        }
+
+        for (size_t bin = 0; bin < m_bins; bin++) {
+            m_smoothedPower[bin] = POWER_SMOOTHING * m_smoothedPower[bin] + (1.0f - POWER_SMOOTHING) * m_power[bin];
+            m_noise[bin] = std::min(m_noise[bin] * NOISE_RISE, m_smoothedPower[bin]);
+
+            const float post = m_power[bin] / (m_noise[bin] + POWER_EPSILON);
+            const float priori = PRIORI_WEIGHT * m_gain[bin] * m_gain[bin] * m_previousPost[bin] +
+                (1.0f - PRIORI_WEIGHT) * std::max(post - 1.0f, 0.0f);
+            m_gain[bin] = std::max(priori / (1.0f + priori), m_gainFloor);
+            m_previousPost[bin] = post;
+        }
+        for (size_t bin = 1; bin < m_bins - 1; bin++) {
+            m_gain[m_size - bin] = m_gain[bin];
+        }
+
+        AudioSimd::Multiply(m_re.data(), m_gain.data(), m_re.data(), m_size);
+        AudioSimd::Multiply(m_im.data(), m_gain.data(), m_im.data(), m_size);
+    }
+
+    AudioNoiseSuppressor::Stats AudioNoiseSuppressor::GetStats() const
+    {
+        Stats stats;
+        stats.frames = m_frames;
+        stats.frameUsAvg = m_frames > 0 ? static_cast<uint32_t>(m_frameNsTotal / m_frames / 1000) : 0;
+        stats.frameUsMax = static_cast<uint32_t>(m_frameNsMax / 1000);
+        stats.hopMs = static_cast<uint32_t>(m_hop * 1000 / m_config.sampleRateHz);
+        stats.bypassed = m_bypassed;
+        return stats;
+    }
+
+} // namespace WPEFramework
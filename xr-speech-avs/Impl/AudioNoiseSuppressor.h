@@ -0,0 +1,107 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include "AudioFft.h"
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace WPEFramework {
+
+    /// Frame based spectral noise suppressor for 16-bit mono PCM. 256 point frames with 50% overlap and a sqrt-Hann
+    /// window are filtered with a decision-directed Wiener gain against a minimum-tracking noise estimate. The gain
+    /// never drops below the configured suppression level. Every frame does the same work so the CPU cost is fixed.
+    /// If the measured average still exceeds the budget the rest of the session is passed through unprocessed.
+    /// Adds one hop (8 ms at 16 kHz) of latency. Not thread safe, it is owned and driven by the SDS writer thread.
+    class AudioNoiseSuppressor {
+    public:
+        struct Config {
+            uint32_t sampleRateHz;
+            uint32_t suppressionDb;   ///< Maximum attenuation applied to noise bins
+            uint32_t budgetUs;        ///< Average frame processing time allowed, 0 for no limit
+        };
+
+        struct Stats {
+            uint64_t frames;
+            uint32_t frameUsAvg;
+            uint32_t frameUsMax;
+            uint32_t hopMs;           ///< Audio per frame, the real time budget of one frame
+            bool bypassed;            ///< The current session exceeded the CPU budget
+        };
+
+        static std::unique_ptr<AudioNoiseSuppressor> create(const Config& config);
+
+        AudioNoiseSuppressor(const AudioNoiseSuppressor&) = delete;
+        AudioNoiseSuppressor& operator=(const AudioNoiseSuppressor&) = delete;
+        ~AudioNoiseSuppressor() = default;
+
+        /// Appends the suppressed audio available for this input to out
+        void Process(const uint8_t data[], const size_t length, std::vector<uint8_t>& out);
+
+        /// Appends the audio still held back to out and starts a new session, the noise estimate is kept
+        void Flush(std::vector<uint8_t>& out);
+
+        /// Samples of latency, each session starts with this much silence
+        size_t DelaySamples() const { return m_hop; }
+
+        Stats GetStats() const;
+
+    private:
+        AudioNoiseSuppressor(const Config& config, std::unique_ptr<AudioFft> fft);
+
+        void ProcessHop(std::vector<uint8_t>& out, const size_t outSamples);
+        void Suppress();
+
+    private:
+        const Config m_config;
+        std::unique_ptr<AudioFft> m_fft;
+        const size_t m_size;
+        const size_t m_hop;
+        const size_t m_bins;
+        const float m_gainFloor;
+
+        std::vector<float> m_window;
+        std::vector<float> m_input;
+        std::vector<float> m_overlap;
+        std::vector<float> m_re;
+        std::vector<float> m_im;
+        std::vector<float> m_power;
+        std::vector<float> m_smoothedPower;
+        std::vector<float> m_noise;
+        std::vector<float> m_gain;
+        std::vector<float> m_previousPost;
+        std::vector<int16_t> m_pcm;
+        size_t m_pending;
+        size_t m_outstanding;
+        uint32_t m_noiseFrames;
+
+        bool m_bypassed;
+        uint64_t m_frames;
+        uint64_t m_frameNsTotal;
+        uint64_t m_frameNsMax;
+        double m_frameNsAvg;
+    };
+
+} // namespace WPEFramework
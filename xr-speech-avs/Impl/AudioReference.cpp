@@ -0,0 +1,87 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioReference.h"
+
+#include <algorithm>
+
+namespace WPEFramework {
+
+    std::shared_ptr<AudioReference> AudioReference::create(const uint32_t sampleRateHz, const uint32_t historyMs)
+    {
+        if (sampleRateHz == 0 || historyMs == 0) {
+            XLOGD_ERROR("Invalid audio reference configuration");
+            return nullptr;
+        }
+        // Power of two so positions map to slots with a mask
+        size_t size = 1;
+        while (size < static_cast<size_t>(sampleRateHz) * historyMs / 1000) {
+            size <<= 1;
+        }
+        return std::shared_ptr<AudioReference>(new AudioReference(sampleRateHz, size));
+    }
+
+    AudioReference::AudioReference(const uint32_t sampleRateHz, const size_t size)
+        : m_sampleRateHz(sampleRateHz)
+        , m_mask(size - 1)
+        , m_mix(size, 0)
+        , m_positions(size, 0)
+    {
+    }
+
+    uint64_t AudioReference::Position(const uint64_t timeNs) const
+    {
+        return timeNs / 1000 * m_sampleRateHz / 1000000;
+    }
+
+    void AudioReference::Write(const int16_t samples[], const size_t count, const uint64_t position)
+    {
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        for (size_t index = 0; index < count; index++) {
+            const uint64_t slotPosition = position + index;
+            const size_t slot = slotPosition & m_mask;
+            if (m_positions[slot] != slotPosition) {
+                m_positions[slot] = slotPosition;
+                m_mix[slot] = 0;
+            }
+            m_mix[slot] += samples[index];
+        }
+    }
+
+    bool AudioReference::Read(const uint64_t position, float out[], const size_t count)
+    {
+        bool active = false;
+        const uint64_t first = position - count;
+
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        for (size_t index = 0; index < count; index++) {
+            const uint64_t slotPosition = first + index;
+            const size_t slot = slotPosition & m_mask;
+            if (m_positions[slot] == slotPosition) {
+                out[index] = static_cast<float>(std::min<int32_t>(std::max<int32_t>(m_mix[slot], -32768), 32767));
+                active = active || m_mix[slot] != 0;
+            } else {
+                out[index] = 0.0f;
+            }
+        }
+        return active;
+    }
+
+} // namespace WPEFramework
@@ -0,0 +1,66 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+namespace WPEFramework {
+
+    /// Far-end reference for echo cancellation: the audio rendered by the media players, mixed down to 16-bit mono
+    /// and indexed by steady clock sample position. Any number of players write concurrently and are summed, the
+    /// echo canceller reads the mix back for the time its microphone audio was captured. Positions that were not
+    /// written read as silence. Thread safe.
+    class AudioReference {
+    public:
+        static std::shared_ptr<AudioReference> create(const uint32_t sampleRateHz, const uint32_t historyMs);
+
+        AudioReference(const AudioReference&) = delete;
+        AudioReference& operator=(const AudioReference&) = delete;
+        ~AudioReference() = default;
+
+        /// Sample position of a steady clock time
+        uint64_t Position(const uint64_t timeNs) const;
+
+        /// Mixes count samples starting at position
+        void Write(const int16_t samples[], const size_t count, const uint64_t position);
+
+        /// Reads the count samples ending before position, returns false if they are all silent
+        bool Read(const uint64_t position, float out[], const size_t count);
+
+        uint32_t SampleRateHz() const { return m_sampleRateHz; }
+
+    private:
+        AudioReference(const uint32_t sampleRateHz, const size_t size);
+
+    private:
+        const uint32_t m_sampleRateHz;
+        const size_t m_mask;
+        std::mutex m_mutex;
+        std::vector<int32_t> m_mix;
+        std::vector<uint64_t> m_positions;
+    };
+
+} // namespace WPEFramework
@@ -0,0 +1,161 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioReferenceSink.h"
+
+#include <chrono>
+
+#if defined(GSTREAMER_MEDIA_PLAYER)
+#include <gst/gst.h>
+
+namespace {
+
+    std::shared_ptr<WPEFramework::AudioReference> s_reference;
+    std::string s_audioSink;
+
+    // Handoffs of one player closer than this to the end of its previous buffer continue it seamlessly
+    const uint64_t CONTINUITY_MS = 20;
+
+    GstStaticPadTemplate s_sinkTemplate = GST_STATIC_PAD_TEMPLATE("sink", GST_PAD_SINK, GST_PAD_ALWAYS, GST_STATIC_CAPS_ANY);
+
+} // namespace
+
+G_BEGIN_DECLS
+
+typedef struct _AvsReferenceSink {
+    GstBin parent;
+    guint64 nextPosition;
+} AvsReferenceSink;
+
+typedef struct _AvsReferenceSinkClass {
+    GstBinClass parentClass;
+} AvsReferenceSinkClass;
+
+G_END_DECLS
+
+G_DEFINE_TYPE(AvsReferenceSink, avs_reference_sink, GST_TYPE_BIN)
+
+static void avs_reference_sink_handoff(GstElement* element, GstBuffer* buffer, GstPad* pad, gpointer userData)
+{
+    AvsReferenceSink* self = static_cast<AvsReferenceSink*>(userData);
+    GstMapInfo map;
+    if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+        return;
+    }
+
+    // The tap branch syncs to the pipeline clock, a handoff happens when the buffer is due for rendering
+    const uint64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    const uint64_t continuity = static_cast<uint64_t>(s_reference->SampleRateHz()) * CONTINUITY_MS / 1000;
+    uint64_t position = s_reference->Position(nowNs);
+    if (self->nextPosition != 0 && position + continuity > self->nextPosition && position < self->nextPosition + continuity) {
+        position = self->nextPosition;
+    }
+
+    const size_t count = map.size / sizeof(int16_t);
+    s_reference->Write(reinterpret_cast<const int16_t*>(map.data), count, position);
+    self->nextPosition = position + count;
+
+    gst_buffer_unmap(buffer, &map);
+}
+
+static void avs_reference_sink_class_init(AvsReferenceSinkClass* klass)
+{
+    GstElementClass* elementClass = GST_ELEMENT_CLASS(klass);
+    gst_element_class_add_static_pad_template(elementClass, &s_sinkTemplate);
+    gst_element_class_set_static_metadata(elementClass, "AVS reference sink", "Sink/Audio",
+        "Plays audio and taps it as the echo cancellation reference", "RDK Management");
+}
+
+static void avs_reference_sink_init(AvsReferenceSink* self)
+{
+    self->nextPosition = 0;
+
+    //  tee ! queue ! <audio sink>
+    //  tee ! queue ! audioconvert ! audioresample ! capsfilter ! fakesink (handoff into the reference)
+    GstElement* tee = gst_element_factory_make("tee", NULL);
+    GstElement* playQueue = gst_element_factory_make("queue", NULL);
+    GstElement* playSink = gst_element_factory_make(s_audioSink.c_str(), NULL);
+    GstElement* tapQueue = gst_element_factory_make("queue", NULL);
+    GstElement* convert = gst_element_factory_make("audioconvert", NULL);
+    GstElement* resample = gst_element_factory_make("audioresample", NULL);
+    GstElement* capsFilter = gst_element_factory_make("capsfilter", NULL);
+    GstElement* tapSink = gst_element_factory_make("fakesink", NULL);
+    if (!tee || !playQueue || !playSink || !tapQueue || !convert || !resample || !capsFilter || !tapSink) {
+        XLOGD_ERROR("Failed to create the reference sink elements, audio sink <%s>", s_audioSink.c_str());
+        return;
+    }
+
+    GstCaps* caps = gst_caps_new_simple("audio/x-raw",
+        "format", G_TYPE_STRING, "S16LE",
+        "layout", G_TYPE_STRING, "interleaved",
+        "rate", G_TYPE_INT, static_cast<gint>(s_reference->SampleRateHz()),
+        "channels", G_TYPE_INT, 1,
+        NULL);
+    g_object_set(capsFilter, "caps", caps, NULL);
+    gst_caps_unref(caps);
+
+    // The tap must never hold back playback
+    g_object_set(tapQueue, "leaky", 2, NULL);
+    g_object_set(tapSink, "signal-handoffs", TRUE, "sync", TRUE, "async", FALSE, NULL);
+    g_signal_connect(tapSink, "handoff", G_CALLBACK(avs_reference_sink_handoff), self);
+
+    gst_bin_add_many(GST_BIN(self), tee, playQueue, playSink, tapQueue, convert, resample, capsFilter, tapSink, NULL);
+    if (!gst_element_link_many(tee, playQueue, playSink, NULL) ||
+        !gst_element_link_many(tee, tapQueue, convert, resample, capsFilter, tapSink, NULL)) {
+        XLOGD_ERROR("Failed to link the reference sink");
+        return;
+    }
+
+    GstPad* teeSink = gst_element_get_static_pad(tee, "sink");
+    gst_element_add_pad(GST_ELEMENT(self), gst_ghost_pad_new("sink", teeSink));
+    gst_object_unref(teeSink);
+}
+#endif
+
+namespace WPEFramework {
+
+    const char* AudioReferenceSink::ELEMENT_NAME = "avsreferencesink";
+
+    bool AudioReferenceSink::Register(std::shared_ptr<AudioReference> reference, const std::string& audioSink)
+    {
+        if (!reference || audioSink.empty() || audioSink == ELEMENT_NAME) {
+            XLOGD_ERROR("Invalid reference sink configuration");
+            return false;
+        }
+#if defined(GSTREAMER_MEDIA_PLAYER)
+        s_reference = reference;
+        s_audioSink = audioSink;
+
+        if (!gst_is_initialized()) {
+            gst_init(NULL, NULL);
+        }
+        if (!gst_element_register(NULL, ELEMENT_NAME, GST_RANK_NONE, avs_reference_sink_get_type())) {
+            XLOGD_ERROR("Failed to register <%s>", ELEMENT_NAME);
+            return false;
+        }
+        XLOGD_INFO("Registered <%s> playing through <%s>", ELEMENT_NAME, audioSink.c_str());
+        return true;
+#else
+        XLOGD_ERROR("Echo cancellation reference requires the GStreamer media player");
+        return false;
+#endif
+    }
+
+} // namespace WPEFramework
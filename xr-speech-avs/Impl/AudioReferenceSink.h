@@ -0,0 +1,43 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include "AudioReference.h"
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <string>
+
+namespace WPEFramework {
+
+    /// GStreamer sink element that plays through the configured audio sink and taps the rendered audio into an
+    /// AudioReference. Selecting it as gstreamerMediaPlayer.audioSink gives the echo canceller the output of every
+    /// media player created by the SDK without changes to the players.
+    class AudioReferenceSink {
+    public:
+        static const char* ELEMENT_NAME;
+
+        /// Registers the element, must be called before the media players are created
+        static bool Register(std::shared_ptr<AudioReference> reference, const std::string& audioSink);
+    };
+
+} // namespace WPEFramework
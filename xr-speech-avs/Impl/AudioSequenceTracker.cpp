@@ -0,0 +1,223 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioSequenceTracker.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace WPEFramework {
+
+    // Repeated frames are attenuated by 6 dB per concealed frame
+    static const uint32_t CONCEAL_FADE_SHIFT = 1;
+    // After this many repeated frames concealment switches to comfort noise
+    static const uint32_t CONCEAL_REPEAT_FRAMES = 3;
+    // Comfort noise peak amplitude, about -60 dBFS
+    static const int32_t COMFORT_NOISE_AMPLITUDE = 32;
+
+    static int32_t SequenceDiff(const uint32_t a, const uint32_t b)
+    {
+        return static_cast<int32_t>(a - b);
+    }
+
+    std::unique_ptr<AudioSequenceTracker> AudioSequenceTracker::create(const Config& config)
+    {
+        if (config.windowFrames == 0 || config.defaultFrameBytes == 0 || (config.defaultFrameBytes & 1) != 0) {
+            XLOGD_ERROR("Invalid sequence tracker configuration");
+            return nullptr;
+        }
+        return std::unique_ptr<AudioSequenceTracker>(new AudioSequenceTracker(config));
+    }
+
+    AudioSequenceTracker::AudioSequenceTracker(const Config& config)
+        : m_config(config)
+        , m_slots(config.windowFrames)
+        , m_started{ false }
+        , m_nextSeq{ 0 }
+        , m_highestSeq{ 0 }
+        , m_lastPushedSeq{ 0 }
+        , m_lastPushedDropped{ false }
+        , m_concealRun{ 0 }
+        , m_noiseState{ 0x12345678 }
+        , m_stats()
+    {
+        for (auto& slot : m_slots) {
+            slot.valid = false;
+            slot.data.reserve(config.defaultFrameBytes);
+        }
+        m_lastFrame.reserve(config.defaultFrameBytes);
+    }
+
+    void AudioSequenceTracker::Push(const uint32_t sequenceNo, const bool continuation, const uint8_t data[], const size_t length, std::vector<uint8_t>& out)
+    {
+        if (sequenceNo == 0) {
+            out.insert(out.end(), data, data + length);
+            return;
+        }
+
+        if (continuation) {
+            if (!m_started || sequenceNo != m_lastPushedSeq || m_lastPushedDropped) {
+                // The start of this frame was dropped, so is the rest of it
+                return;
+            }
+            Slot& slot = SlotFor(sequenceNo);
+            if (slot.valid && slot.sequenceNo == sequenceNo) {
+                slot.data.insert(slot.data.end(), data, data + length);
+            } else {
+                out.insert(out.end(), data, data + length);
+                m_lastFrame.insert(m_lastFrame.end(), data, data + length);
+            }
+            return;
+        }
+
+        m_stats.received++;
+
+        if (!m_started) {
+            m_started = true;
+            m_nextSeq = sequenceNo;
+            m_highestSeq = sequenceNo;
+        }
+        m_lastPushedSeq = sequenceNo;
+        m_lastPushedDropped = false;
+
+        if (SequenceDiff(sequenceNo, m_nextSeq) < 0) {
+            // Too late or a duplicate, its position has already been released or concealed
+            m_stats.late++;
+            m_lastPushedDropped = true;
+            return;
+        }
+
+        if (SequenceDiff(sequenceNo, m_highestSeq) < 0) {
+            m_stats.reordered++;
+        } else {
+            m_highestSeq = sequenceNo;
+        }
+
+        const uint32_t gap = static_cast<uint32_t>(SequenceDiff(sequenceNo, m_nextSeq));
+        if (gap >= m_config.windowFrames + m_config.maxConcealFrames) {
+            // Discontinuity, release what is held and restart at this frame without concealment
+            uint32_t held = 0;
+            for (uint32_t index = 0; index < m_config.windowFrames; index++) {
+                Slot& slot = SlotFor(m_nextSeq + index);
+                if (slot.valid && slot.sequenceNo == m_nextSeq + index) {
+                    Emit(slot.data, out);
+                    slot.valid = false;
+                    held++;
+                }
+            }
+            m_stats.lost += gap - held;
+            m_nextSeq = sequenceNo;
+        } else {
+            // Frames that fall out of the window are given up on
+            while (SequenceDiff(sequenceNo, m_nextSeq) >= static_cast<int32_t>(m_config.windowFrames)) {
+                Slot& slot = SlotFor(m_nextSeq);
+                if (slot.valid && slot.sequenceNo == m_nextSeq) {
+                    Emit(slot.data, out);
+                    slot.valid = false;
+                } else {
+                    m_stats.lost++;
+                    Conceal(out);
+                }
+                m_nextSeq++;
+            }
+        }
+
+        Slot& slot = SlotFor(sequenceNo);
+        slot.valid = true;
+        slot.sequenceNo = sequenceNo;
+        slot.data.assign(data, data + length);
+
+        Release(out);
+    }
+
+    void AudioSequenceTracker::Flush(std::vector<uint8_t>& out)
+    {
+        if (m_started) {
+            while (SequenceDiff(m_highestSeq, m_nextSeq) >= 0) {
+                Slot& slot = SlotFor(m_nextSeq);
+                if (slot.valid && slot.sequenceNo == m_nextSeq) {
+                    Emit(slot.data, out);
+                    slot.valid = false;
+                } else {
+                    m_stats.lost++;
+                    Conceal(out);
+                }
+                m_nextSeq++;
+            }
+        }
+        for (auto& slot : m_slots) {
+            slot.valid = false;
+        }
+        m_started = false;
+        m_concealRun = 0;
+        m_lastFrame.clear();
+    }
+
+    void AudioSequenceTracker::ResetStats()
+    {
+        m_stats = Stats();
+    }
+
+    void AudioSequenceTracker::Release(std::vector<uint8_t>& out)
+    {
+        Slot* slot = &SlotFor(m_nextSeq);
+        while (slot->valid && slot->sequenceNo == m_nextSeq) {
+            Emit(slot->data, out);
+            slot->valid = false;
+            m_nextSeq++;
+            slot = &SlotFor(m_nextSeq);
+        }
+    }
+
+    void AudioSequenceTracker::Emit(const std::vector<uint8_t>& frame, std::vector<uint8_t>& out)
+    {
+        out.insert(out.end(), frame.begin(), frame.end());
+        m_lastFrame.assign(frame.begin(), frame.end());
+        m_concealRun = 0;
+    }
+
+    void AudioSequenceTracker::Conceal(std::vector<uint8_t>& out)
+    {
+        const size_t length = m_lastFrame.empty() ? m_config.defaultFrameBytes : (m_lastFrame.size() & ~static_cast<size_t>(1));
+        const size_t offset = out.size();
+        out.resize(offset + length);
+        int16_t* samples = reinterpret_cast<int16_t*>(&out[offset]);
+        const size_t count = length / sizeof(int16_t);
+
+        m_concealRun++;
+        m_stats.concealed++;
+
+        if (!m_lastFrame.empty() && m_concealRun <= CONCEAL_REPEAT_FRAMES) {
+            // Repeat the last good frame with a fade across it so successive repeats decay smoothly
+            const int16_t* last = reinterpret_cast<const int16_t*>(m_lastFrame.data());
+            const int32_t shift = (m_concealRun - 1) * CONCEAL_FADE_SHIFT;
+            for (size_t index = 0; index < count; index++) {
+                const int32_t gain = static_cast<int32_t>(((count - index) * 32768) / count / 2 + 16384);
+                samples[index] = static_cast<int16_t>(((static_cast<int32_t>(last[index]) >> shift) * gain) >> 15);
+            }
+        } else {
+            for (size_t index = 0; index < count; index++) {
+                m_noiseState = m_noiseState * 1664525u + 1013904223u;
+                samples[index] = static_cast<int16_t>(static_cast<int32_t>(m_noiseState >> 16) % COMFORT_NOISE_AMPLITUDE);
+            }
+        }
+    }
+
+} // namespace WPEFramework
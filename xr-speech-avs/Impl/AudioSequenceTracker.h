@@ -0,0 +1,99 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace WPEFramework {
+
+    /// Tracks the Voice_Data sequence numbers of a session. Frames are held in a small reorder window, released in
+    /// sequence order and missing frames are concealed so the SDS receives continuous audio.
+    /// A sequence number of 0 marks an unsequenced source, those frames are passed through untouched.
+    /// Not thread safe, it is owned and driven by the SDS writer thread.
+    class AudioSequenceTracker {
+    public:
+        struct Config {
+            uint32_t windowFrames;       ///< Frames held back waiting for late arrivals
+            uint32_t maxConcealFrames;   ///< Larger gaps are treated as a discontinuity and not concealed
+            uint32_t defaultFrameBytes;  ///< Concealment frame size until a frame has been seen
+        };
+
+        struct Stats {
+            uint64_t received;
+            uint64_t lost;
+            uint64_t reordered;
+            uint64_t concealed;
+            uint64_t late;
+        };
+
+        static std::unique_ptr<AudioSequenceTracker> create(const Config& config);
+
+        AudioSequenceTracker(const AudioSequenceTracker&) = delete;
+        AudioSequenceTracker& operator=(const AudioSequenceTracker&) = delete;
+        ~AudioSequenceTracker() = default;
+
+        /// Adds a frame and appends the audio that is now in order to out. A continuation is a further part of the
+        /// frame pushed last, the staging queue splits large frames over several slots.
+        void Push(const uint32_t sequenceNo, const bool continuation, const uint8_t data[], const size_t length, std::vector<uint8_t>& out);
+
+        /// Releases everything held in the window to out and forgets the sequence position, used at stream end
+        void Flush(std::vector<uint8_t>& out);
+
+        /// Starts a new set of per session counters
+        void ResetStats();
+
+        Stats GetStats() const { return m_stats; }
+
+    private:
+        struct Slot {
+            bool valid;
+            uint32_t sequenceNo;
+            std::vector<uint8_t> data;
+        };
+
+        AudioSequenceTracker(const Config& config);
+
+        Slot& SlotFor(const uint32_t sequenceNo) { return m_slots[sequenceNo % m_slots.size()]; }
+        void Release(std::vector<uint8_t>& out);
+        void Emit(const std::vector<uint8_t>& frame, std::vector<uint8_t>& out);
+        void Conceal(std::vector<uint8_t>& out);
+
+    private:
+        const Config m_config;
+        std::vector<Slot> m_slots;
+        std::vector<uint8_t> m_lastFrame;
+
+        bool m_started;
+        uint32_t m_nextSeq;
+        uint32_t m_highestSeq;
+        uint32_t m_lastPushedSeq;
+        bool m_lastPushedDropped;
+        uint32_t m_concealRun;
+        uint32_t m_noiseState;
+
+        Stats m_stats;
+    };
+
+} // namespace WPEFramework
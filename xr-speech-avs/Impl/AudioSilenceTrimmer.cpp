@@ -0,0 +1,131 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioSilenceTrimmer.h"
+
+namespace WPEFramework {
+
+    static const uint32_t ONSET_FRAME_MS = 10;
+    static const uint32_t PCM16_BYTES = 2;
+    // Only the onset is used, the end of speech never triggers within a trimmed session
+    static const uint32_t ONSET_ZCR_PERCENT = 30;
+    static const uint32_t ONSET_HANGOVER_MS = 60000;
+
+    std::unique_ptr<AudioSilenceTrimmer> AudioSilenceTrimmer::create(const Config& config)
+    {
+        if (config.sampleRateHz < 1000 || config.onsetMs == 0 || config.maxTrimMs == 0) {
+            XLOGD_ERROR("Invalid silence trimmer configuration");
+            return nullptr;
+        }
+
+        AudioVad::Config vadConfig;
+        vadConfig.sampleRateHz = config.sampleRateHz;
+        vadConfig.frameMs = ONSET_FRAME_MS;
+        vadConfig.thresholdDb = config.thresholdDb;
+        vadConfig.zcrPercent = ONSET_ZCR_PERCENT;
+        vadConfig.minSpeechMs = config.onsetMs;
+        vadConfig.hangoverMs = ONSET_HANGOVER_MS;
+        std::unique_ptr<AudioVad> vad = AudioVad::create(vadConfig);
+        if (!vad) {
+            return nullptr;
+        }
+        return std::unique_ptr<AudioSilenceTrimmer>(new AudioSilenceTrimmer(config, std::move(vad)));
+    }
+
+    AudioSilenceTrimmer::AudioSilenceTrimmer(const Config& config, std::unique_ptr<AudioVad> vad)
+        : m_config(config)
+        , m_bytesPerMs(config.sampleRateHz / 1000 * PCM16_BYTES)
+        , m_keepBytes((config.padMs + config.onsetMs + ONSET_FRAME_MS) * m_bytesPerMs)
+        , m_vad(std::move(vad))
+        , m_trimming(false)
+        , m_trimmedBytes(0)
+        , m_onset(false)
+        , m_sessions(0)
+        , m_trimmedMsTotal(0)
+    {
+        m_held.reserve(m_keepBytes + config.sampleRateHz / 10 * PCM16_BYTES);
+    }
+
+    void AudioSilenceTrimmer::Reset(const bool enabled)
+    {
+        if (m_trimmedBytes > 0) {
+            m_sessions++;
+            m_trimmedMsTotal += m_trimmedBytes / m_bytesPerMs;
+        }
+        m_vad->Reset();
+        m_held.clear();
+        m_trimming = enabled;
+        m_trimmedBytes = 0;
+        m_onset = false;
+    }
+
+    void AudioSilenceTrimmer::Process(const uint8_t data[], const size_t length, std::vector<uint8_t>& out)
+    {
+        if (!m_trimming) {
+            out.insert(out.end(), data, data + length);
+            return;
+        }
+
+        m_vad->Process(reinterpret_cast<const int16_t*>(data), length / PCM16_BYTES);
+        m_held.insert(m_held.end(), data, data + length);
+
+        if (m_vad->GetStats().speechMs >= m_config.onsetMs) {
+            m_onset = true;
+            Release(out);
+            return;
+        }
+
+        // Keep the pad and the speech still short of the onset, older audio is dropped
+        if (m_held.size() > m_keepBytes) {
+            const size_t drop = (m_held.size() - m_keepBytes) & ~static_cast<size_t>(PCM16_BYTES - 1);
+            m_held.erase(m_held.begin(), m_held.begin() + drop);
+            m_trimmedBytes += drop;
+        }
+        if (m_trimmedBytes >= static_cast<uint64_t>(m_config.maxTrimMs) * m_bytesPerMs) {
+            XLOGD_DEBUG("No speech onset within <%u ms>, trimming stopped", m_config.maxTrimMs);
+            Release(out);
+        }
+    }
+
+    void AudioSilenceTrimmer::Flush(std::vector<uint8_t>& out)
+    {
+        if (m_trimming) {
+            Release(out);
+        }
+    }
+
+    void AudioSilenceTrimmer::Release(std::vector<uint8_t>& out)
+    {
+        out.insert(out.end(), m_held.begin(), m_held.end());
+        m_held.clear();
+        m_trimming = false;
+    }
+
+    AudioSilenceTrimmer::Stats AudioSilenceTrimmer::GetStats() const
+    {
+        Stats stats;
+        stats.trimmedMs = static_cast<uint32_t>(m_trimmedBytes / m_bytesPerMs);
+        stats.onset = m_onset;
+        stats.sessions = m_sessions + (m_trimmedBytes > 0 ? 1 : 0);
+        stats.trimmedMsTotal = m_trimmedMsTotal + m_trimmedBytes / m_bytesPerMs;
+        return stats;
+    }
+
+} // namespace WPEFramework
@@ -0,0 +1,89 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include "AudioVad.h"
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace WPEFramework {
+
+    /// Holds back the leading silence of an utterance until speech onset, then releases the last padMs of pre-onset
+    /// audio followed by everything after it. Trimming gives up after maxTrimMs so a quiet talker is never starved.
+    /// Works on 16-bit mono PCM in front of the SDS, so it applies to every AudioProvider reading the stream.
+    /// Not thread safe, it is owned and driven by the SDS writer thread.
+    class AudioSilenceTrimmer {
+    public:
+        struct Config {
+            uint32_t sampleRateHz;
+            uint32_t padMs;           ///< Pre-onset audio kept ahead of the speech
+            uint32_t onsetMs;         ///< Speech required to declare the onset
+            uint32_t maxTrimMs;       ///< Longest leading silence trimmed
+            uint32_t thresholdDb;     ///< Energy above the noise floor that marks speech
+        };
+
+        struct Stats {
+            uint32_t trimmedMs;       ///< Audio trimmed from the current session
+            bool onset;               ///< Speech onset found in the current session
+            uint64_t sessions;        ///< Sessions trimmed since start up
+            uint64_t trimmedMsTotal;
+        };
+
+        static std::unique_ptr<AudioSilenceTrimmer> create(const Config& config);
+
+        AudioSilenceTrimmer(const AudioSilenceTrimmer&) = delete;
+        AudioSilenceTrimmer& operator=(const AudioSilenceTrimmer&) = delete;
+        ~AudioSilenceTrimmer() = default;
+
+        /// Starts a new session, a disabled session passes all audio through
+        void Reset(const bool enabled);
+
+        /// Appends the audio to release for this input to out
+        void Process(const uint8_t data[], const size_t length, std::vector<uint8_t>& out);
+
+        /// Releases the audio still held waiting for an onset to out, used at stream end so a short utterance is kept
+        void Flush(std::vector<uint8_t>& out);
+
+        Stats GetStats() const;
+
+    private:
+        AudioSilenceTrimmer(const Config& config, std::unique_ptr<AudioVad> vad);
+
+        void Release(std::vector<uint8_t>& out);
+
+    private:
+        const Config m_config;
+        const size_t m_bytesPerMs;
+        const size_t m_keepBytes;
+        std::unique_ptr<AudioVad> m_vad;
+        std::vector<uint8_t> m_held;
+        bool m_trimming;
+        uint64_t m_trimmedBytes;
+        bool m_onset;
+        uint64_t m_sessions;
+        uint64_t m_trimmedMsTotal;
+    };
+
+} // namespace WPEFramework
@@ -0,0 +1,332 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUDIO_SIMD_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define AUDIO_SIMD_SSE
+#endif
+
+namespace WPEFramework {
+
+    /// Vector kernels shared by the audio ingest stages. NEON and SSE2 paths are selected at compile time with a
+    /// scalar fallback. Lengths must be a multiple of AUDIO_SIMD_WIDTH unless stated otherwise.
+    namespace AudioSimd {
+
+        static constexpr size_t AUDIO_SIMD_WIDTH = 4;
+
+        /// Returns the dot product of a and b
+        inline float DotProduct(const float a[], const float b[], const size_t count)
+        {
+#if defined(AUDIO_SIMD_NEON)
+            float32x4_t acc = vdupq_n_f32(0.0f);
+            for (size_t index = 0; index < count; index += AUDIO_SIMD_WIDTH) {
+                acc = vmlaq_f32(acc, vld1q_f32(a + index), vld1q_f32(b + index));
+            }
+            float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+            return vget_lane_f32(vpadd_f32(sum, sum), 0);
+#elif defined(AUDIO_SIMD_SSE)
+            __m128 acc = _mm_setzero_ps();
+            for (size_t index = 0; index < count; index += AUDIO_SIMD_WIDTH) {
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + index), _mm_loadu_ps(b + index)));
+            }
+            acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+            acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+            return _mm_cvtss_f32(acc);
+#else
+            float sum = 0.0f;
+            for (size_t index = 0; index < count; index++) {
+                sum += a[index] * b[index];
+            }
+            return sum;
+#endif
+        }
+
+        /// Converts float samples to saturated 16-bit PCM rounding half away from zero, any count. Every path rounds
+        /// the same way so x86 and ARM builds produce identical samples.
+        inline void FloatToPcm16(const float in[], int16_t out[], const size_t count)
+        {
+            size_t index = 0;
+#if defined(AUDIO_SIMD_NEON)
+            const uint32x4_t signMask = vdupq_n_u32(0x80000000u);
+            const uint32x4_t half = vreinterpretq_u32_f32(vdupq_n_f32(0.5f));
+            for (; index + AUDIO_SIMD_WIDTH <= count; index += AUDIO_SIMD_WIDTH) {
+                const float32x4_t value = vld1q_f32(in + index);
+                const float32x4_t offset = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(value), signMask), half));
+                // Truncating conversion, saturated on the way to 16 bits
+                const int32x4_t rounded = vcvtq_s32_f32(vaddq_f32(value, offset));
+                vst1_s16(out + index, vqmovn_s32(rounded));
+            }
+#elif defined(AUDIO_SIMD_SSE)
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 upper = _mm_set1_ps(32767.0f);
+            const __m128 lower = _mm_set1_ps(-32768.0f);
+            for (; index + AUDIO_SIMD_WIDTH <= count; index += AUDIO_SIMD_WIDTH) {
+                const __m128 value = _mm_loadu_ps(in + index);
+                const __m128 offset = _mm_or_ps(_mm_and_ps(value, signMask), half);
+                // Clamped first, the truncating conversion has no saturation of its own
+                const __m128 clamped = _mm_max_ps(_mm_min_ps(_mm_add_ps(value, offset), upper), lower);
+                const __m128i rounded = _mm_cvttps_epi32(clamped);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + index), _mm_packs_epi32(rounded, rounded));
+            }
+#endif
+            for (; index < count; index++) {
+                const float value = in[index] + (in[index] < 0.0f ? -0.5f : 0.5f);
+                out[index] = static_cast<int16_t>(value >= 32767.0f ? 32767 : (value <= -32768.0f ? -32768 : static_cast<int32_t>(value)));
+            }
+        }
+
+        /// Returns the sum of the squared samples, any count
+        inline uint64_t SumSquares(const int16_t in[], const size_t count)
+        {
+            size_t index = 0;
+            uint64_t sum = 0;
+#if defined(AUDIO_SIMD_NEON)
+            int64x2_t acc = vdupq_n_s64(0);
+            for (; index + 2 * AUDIO_SIMD_WIDTH <= count; index += 2 * AUDIO_SIMD_WIDTH) {
+                const int16x8_t value = vld1q_s16(in + index);
+                acc = vpadalq_s32(acc, vmull_s16(vget_low_s16(value), vget_low_s16(value)));
+                acc = vpadalq_s32(acc, vmull_s16(vget_high_s16(value), vget_high_s16(value)));
+            }
+            sum = static_cast<uint64_t>(vgetq_lane_s64(acc, 0) + vgetq_lane_s64(acc, 1));
+#elif defined(AUDIO_SIMD_SSE)
+            // A pair of squares is at most 2^31, it fits the 32-bit lanes once they are read as unsigned
+            const __m128i zero = _mm_setzero_si128();
+            __m128i acc = _mm_setzero_si128();
+            for (; index + 2 * AUDIO_SIMD_WIDTH <= count; index += 2 * AUDIO_SIMD_WIDTH) {
+                const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + index));
+                const __m128i pairs = _mm_madd_epi16(value, value);
+                acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(pairs, zero));
+                acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(pairs, zero));
+            }
+            uint64_t lanes[2];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+            sum = lanes[0] + lanes[1];
+#endif
+            for (; index < count; index++) {
+                sum += static_cast<uint64_t>(static_cast<int32_t>(in[index]) * in[index]);
+            }
+            return sum;
+        }
+
+        /// Returns the number of sign changes between neighbouring samples, any count
+        inline uint32_t ZeroCrossings(const int16_t in[], const size_t count)
+        {
+            if (count < 2) {
+                return 0;
+            }
+            size_t index = 1;
+            uint32_t crossings = 0;
+#if defined(AUDIO_SIMD_NEON)
+            // Lanes count down by one per crossing, flushed before they can wrap
+            while (index + 2 * AUDIO_SIMD_WIDTH <= count) {
+                int16x8_t acc = vdupq_n_s16(0);
+                for (size_t block = 0; block < 4096 && index + 2 * AUDIO_SIMD_WIDTH <= count; block++, index += 2 * AUDIO_SIMD_WIDTH) {
+                    acc = vaddq_s16(acc, vshrq_n_s16(veorq_s16(vld1q_s16(in + index), vld1q_s16(in + index - 1)), 15));
+                }
+                const int32x4_t wide = vpaddlq_s16(acc);
+                crossings += static_cast<uint32_t>(-(vgetq_lane_s32(wide, 0) + vgetq_lane_s32(wide, 1) + vgetq_lane_s32(wide, 2) + vgetq_lane_s32(wide, 3)));
+            }
+#elif defined(AUDIO_SIMD_SSE)
+            while (index + 2 * AUDIO_SIMD_WIDTH <= count) {
+                __m128i acc = _mm_setzero_si128();
+                for (size_t block = 0; block < 4096 && index + 2 * AUDIO_SIMD_WIDTH <= count; block++, index += 2 * AUDIO_SIMD_WIDTH) {
+                    const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + index));
+                    const __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + index - 1));
+                    acc = _mm_add_epi16(acc, _mm_srai_epi16(_mm_xor_si128(current, previous), 15));
+                }
+                const __m128i wide = _mm_madd_epi16(acc, _mm_set1_epi16(1));
+                int32_t lanes[4];
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), wide);
+                crossings += static_cast<uint32_t>(-(lanes[0] + lanes[1] + lanes[2] + lanes[3]));
+            }
+#endif
+            for (; index < count; index++) {
+                crossings += ((in[index] ^ in[index - 1]) < 0) ? 1 : 0;
+            }
+            return crossings;
+        }
+
+        /// Returns the largest sample magnitude (saturated to 32767) and counts the samples at or above clipLevel,
+        /// any count
+        inline uint16_t PeakMagnitude(const int16_t in[], const size_t count, const int16_t clipLevel, uint32_t& clips)
+        {
+            size_t index = 0;
+            int16_t peak = 0;
+            clips = 0;
+#if defined(AUDIO_SIMD_NEON)
+            const int16x8_t level = vdupq_n_s16(clipLevel);
+            int16x8_t peaks = vdupq_n_s16(0);
+            while (index + 2 * AUDIO_SIMD_WIDTH <= count) {
+                // Lanes count down by one per clipped sample, flushed before they can wrap
+                int16x8_t acc = vdupq_n_s16(0);
+                for (size_t block = 0; block < 4096 && index + 2 * AUDIO_SIMD_WIDTH <= count; block++, index += 2 * AUDIO_SIMD_WIDTH) {
+                    const int16x8_t magnitude = vqabsq_s16(vld1q_s16(in + index));
+                    peaks = vmaxq_s16(peaks, magnitude);
+                    acc = vaddq_s16(acc, vreinterpretq_s16_u16(vcgeq_s16(magnitude, level)));
+                }
+                const int32x4_t wide = vpaddlq_s16(acc);
+                clips += static_cast<uint32_t>(-(vgetq_lane_s32(wide, 0) + vgetq_lane_s32(wide, 1) + vgetq_lane_s32(wide, 2) + vgetq_lane_s32(wide, 3)));
+            }
+            int16x4_t folded = vmax_s16(vget_low_s16(peaks), vget_high_s16(peaks));
+            folded = vpmax_s16(folded, folded);
+            folded = vpmax_s16(folded, folded);
+            peak = vget_lane_s16(folded, 0);
+#elif defined(AUDIO_SIMD_SSE)
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i level = _mm_set1_epi16(static_cast<int16_t>(clipLevel - 1));
+            __m128i peaks = zero;
+            while (index + 2 * AUDIO_SIMD_WIDTH <= count) {
+                __m128i acc = zero;
+                for (size_t block = 0; block < 4096 && index + 2 * AUDIO_SIMD_WIDTH <= count; block++, index += 2 * AUDIO_SIMD_WIDTH) {
+                    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + index));
+                    const __m128i magnitude = _mm_max_epi16(value, _mm_subs_epi16(zero, value));
+                    peaks = _mm_max_epi16(peaks, magnitude);
+                    acc = _mm_add_epi16(acc, _mm_cmpgt_epi16(magnitude, level));
+                }
+                const __m128i wide = _mm_madd_epi16(acc, _mm_set1_epi16(1));
+                int32_t lanes[4];
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), wide);
+                clips += static_cast<uint32_t>(-(lanes[0] + lanes[1] + lanes[2] + lanes[3]));
+            }
+            peaks = _mm_max_epi16(peaks, _mm_srli_si128(peaks, 8));
+            peaks = _mm_max_epi16(peaks, _mm_srli_si128(peaks, 4));
+            peaks = _mm_max_epi16(peaks, _mm_srli_si128(peaks, 2));
+            peak = static_cast<int16_t>(_mm_extract_epi16(peaks, 0));
+#endif
+            for (; index < count; index++) {
+                const int16_t magnitude = in[index] < -32767 ? 32767 : static_cast<int16_t>(in[index] < 0 ? -in[index] : in[index]);
+                peak = std::max(peak, magnitude);
+                clips += magnitude >= clipLevel ? 1 : 0;
+            }
+            return static_cast<uint16_t>(peak);
+        }
+
+        /// Radix-2 butterflies between the first and second half of re/im (each half long) with twiddles w, any half
+        inline void Butterflies(float re[], float im[], const float wr[], const float wi[], const size_t half)
+        {
+            size_t index = 0;
+            float* reB = re + half;
+            float* imB = im + half;
+#if defined(AUDIO_SIMD_NEON)
+            for (; index + AUDIO_SIMD_WIDTH <= half; index += AUDIO_SIMD_WIDTH) {
+                const float32x4_t br = vld1q_f32(reB + index), bi = vld1q_f32(imB + index);
+                const float32x4_t twr = vld1q_f32(wr + index), twi = vld1q_f32(wi + index);
+                const float32x4_t tr = vmlsq_f32(vmulq_f32(br, twr), bi, twi);
+                const float32x4_t ti = vmlaq_f32(vmulq_f32(br, twi), bi, twr);
+                const float32x4_t ar = vld1q_f32(re + index), ai = vld1q_f32(im + index);
+                vst1q_f32(reB + index, vsubq_f32(ar, tr));
+                vst1q_f32(imB + index, vsubq_f32(ai, ti));
+                vst1q_f32(re + index, vaddq_f32(ar, tr));
+                vst1q_f32(im + index, vaddq_f32(ai, ti));
+            }
+#elif defined(AUDIO_SIMD_SSE)
+            for (; index + AUDIO_SIMD_WIDTH <= half; index += AUDIO_SIMD_WIDTH) {
+                const __m128 br = _mm_loadu_ps(reB + index), bi = _mm_loadu_ps(imB + index);
+                const __m128 twr = _mm_loadu_ps(wr + index), twi = _mm_loadu_ps(wi + index);
+                const __m128 tr = _mm_sub_ps(_mm_mul_ps(br, twr), _mm_mul_ps(bi, twi));
+                const __m128 ti = _mm_add_ps(_mm_mul_ps(br, twi), _mm_mul_ps(bi, twr));
+                const __m128 ar = _mm_loadu_ps(re + index), ai = _mm_loadu_ps(im + index);
+                _mm_storeu_ps(reB + index, _mm_sub_ps(ar, tr));
+                _mm_storeu_ps(imB + index, _mm_sub_ps(ai, ti));
+                _mm_storeu_ps(re + index, _mm_add_ps(ar, tr));
+                _mm_storeu_ps(im + index, _mm_add_ps(ai, ti));
+            }
+#endif
+            for (; index < half; index++) {
+                const float tr = reB[index] * wr[index] - imB[index] * wi[index];
+                const float ti = reB[index] * wi[index] + imB[index] * wr[index];
+                reB[index] = re[index] - tr;
+                imB[index] = im[index] - ti;
+                re[index] += tr;
+                im[index] += ti;
+            }
+        }
+
+        /// out = re^2 + im^2
+        inline void PowerSpectrum(const float re[], const float im[], float out[], const size_t count)
+        {
+#if defined(AUDIO_SIMD_NEON)
+            for (size_t index = 0; index < count; index += AUDIO_SIMD_WIDTH) {
+                const float32x4_t r = vld1q_f32(re + index), i = vld1q_f32(im + index);
+                vst1q_f32(out + index, vmlaq_f32(vmulq_f32(r, r), i, i));
+            }
+#elif defined(AUDIO_SIMD_SSE)
+            for (size_t index = 0; index < count; index += AUDIO_SIMD_WIDTH) {
+                const __m128 r = _mm_loadu_ps(re + index), i = _mm_loadu_ps(im + index);
+                _mm_storeu_ps(out + index, _mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(i, i)));
+            }
+#else
+            for (size_t index = 0; index < count; index++) {
+                out[index] = re[index] * re[index] + im[index] * im[index];
+            }
+#endif
+        }
+
+        /// out = a * b, out may alias a
+        inline void Multiply(const float a[], const float b[], float out[], const size_t count)
+        {
+#if defined(AUDIO_SIMD_NEON)
+            for (size_t index = 0; index < count; index += AUDIO_SIMD_WIDTH) {
+                vst1q_f32(out + index, vmulq_f32(vld1q_f32(a + index), vld1q_f32(b + index)));
+            }
+#elif defined(AUDIO_SIMD_SSE)
+            for (size_t index = 0; index < count; index += AUDIO_SIMD_WIDTH) {
+                _mm_storeu_ps(out + index, _mm_mul_ps(_mm_loadu_ps(a + index), _mm_loadu_ps(b + index)));
+            }
+#else
+            for (size_t index = 0; index < count; index++) {
+                out[index] = a[index] * b[index];
+            }
+#endif
+        }
+
+        /// Accumulates y += scale * x
+        inline void Axpy(float y[], const float x[], const float scale, const size_t count)
+        {
+#if defined(AUDIO_SIMD_NEON)
+            const float32x4_t factor = vdupq_n_f32(scale);
+            for (size_t index = 0; index < count; index += AUDIO_SIMD_WIDTH) {
+                vst1q_f32(y + index, vmlaq_f32(vld1q_f32(y + index), vld1q_f32(x + index), factor));
+            }
+#elif defined(AUDIO_SIMD_SSE)
+            const __m128 factor = _mm_set1_ps(scale);
+            for (size_t index = 0; index < count; index += AUDIO_SIMD_WIDTH) {
+                _mm_storeu_ps(y + index, _mm_add_ps(_mm_loadu_ps(y + index), _mm_mul_ps(_mm_loadu_ps(x + index), factor)));
+            }
+#else
+            for (size_t index = 0; index < count; index++) {
+                y[index] += scale * x[index];
+            }
+#endif
+        }
+
+    } // namespace AudioSimd
+
+} // namespace WPEFramework
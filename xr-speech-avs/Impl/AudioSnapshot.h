@@ -0,0 +1,90 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <stdint.h>
+
+namespace WPEFramework {
+
+    /// Sequence lock publishing a small trivially copyable value from one writer to any number of readers.
+    /// The writer never waits. Readers copy without locking and retry only when they overlap a store, so they can
+    /// poll at any rate without slowing the writer.
+    template <typename T>
+    class AudioSnapshot {
+    public:
+        AudioSnapshot()
+            : m_sequence(0)
+        {
+            for (size_t index = 0; index < WORDS; index++) {
+                m_words[index].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        AudioSnapshot(const AudioSnapshot&) = delete;
+        AudioSnapshot& operator=(const AudioSnapshot&) = delete;
+        ~AudioSnapshot() = default;
+
+        /// Publishes value, single writer only
+        void Store(const T& value)
+        {
+            uint32_t words[WORDS] = {};
+            std::memcpy(words, &value, sizeof(T));
+
+            const uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+            m_sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t index = 0; index < WORDS; index++) {
+                m_words[index].store(words[index], std::memory_order_relaxed);
+            }
+            m_sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        /// Copies the last published value, any thread
+        T Load() const
+        {
+            uint32_t words[WORDS];
+            for (;;) {
+                const uint32_t sequence = m_sequence.load(std::memory_order_acquire);
+                if ((sequence & 1) == 0) {
+                    for (size_t index = 0; index < WORDS; index++) {
+                        words[index] = m_words[index].load(std::memory_order_relaxed);
+                    }
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (m_sequence.load(std::memory_order_relaxed) == sequence) {
+                        break;
+                    }
+                }
+            }
+            T value;
+            std::memcpy(&value, words, sizeof(T));
+            return value;
+        }
+
+    private:
+        static constexpr size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+        std::atomic<uint32_t> m_sequence;
+        std::atomic<uint32_t> m_words[WORDS];
+    };
+
+} // namespace WPEFramework
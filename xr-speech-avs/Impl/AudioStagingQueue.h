@@ -0,0 +1,308 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <errno.h>
+#include <semaphore.h>
+#include <stdint.h>
+#include <sys/uio.h>
+#include <time.h>
+
+// sem_clockwait (glibc 2.30) waits on CLOCK_MONOTONIC, older libraries fall back to a steady clock condition variable
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+#define AUDIO_STAGING_SEM_CLOCKWAIT
+#endif
+
+namespace WPEFramework {
+
+    /// Lock-free single-producer/single-consumer ring that stages voice frames between the xrsr audio thread
+    /// and the SDS writer thread. The producer never blocks: when the ring is full the frame is dropped and counted.
+    class AudioStagingQueue {
+    public:
+        static constexpr size_t FRAME_SIZE_MAX = 1280; ///< Bytes per slot (40 ms of 16 kHz / 16-bit mono)
+
+        struct Frame {
+            uint32_t sequenceNo;
+            uint32_t chunk;      ///< Index of the slot within a frame split over several slots, 0 for the first
+            uint32_t chunks;     ///< Number of slots the frame was split over
+            uint32_t length;
+            uint64_t enqueuedNs;
+            uint8_t data[FRAME_SIZE_MAX];
+        };
+
+        struct Stats {
+            uint32_t capacity;
+            uint32_t depth;
+            uint32_t highWaterMark;
+            uint64_t enqueued;
+            uint64_t dropped;
+            uint64_t committed;
+            uint32_t latencyUsMin;
+            uint32_t latencyUsAvg;
+            uint32_t latencyUsMax;
+        };
+
+        /// @param capacity Number of frame slots, must be a power of two
+        static std::unique_ptr<AudioStagingQueue> create(size_t capacity)
+        {
+            if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+                XLOGD_ERROR("Invalid staging queue capacity <%zu>", capacity);
+                return nullptr;
+            }
+            std::unique_ptr<AudioStagingQueue> queue(new AudioStagingQueue(capacity));
+            if (!queue->m_frames) {
+                XLOGD_ERROR("Failed to allocate staging queue");
+                return nullptr;
+            }
+            return queue;
+        }
+
+        AudioStagingQueue(const AudioStagingQueue&) = delete;
+        AudioStagingQueue& operator=(const AudioStagingQueue&) = delete;
+        ~AudioStagingQueue()
+        {
+#if defined(AUDIO_STAGING_SEM_CLOCKWAIT)
+            sem_destroy(&m_ready);
+#endif
+        }
+
+        /// Producer side. Frames larger than a slot are split over consecutive slots; all or nothing is queued.
+        bool Push(const uint32_t sequenceNo, const uint8_t data[], const size_t length)
+        {
+            struct iovec frame;
+            frame.iov_base = const_cast<uint8_t*>(data);
+            frame.iov_len = length;
+            if (PushV(sequenceNo, &frame, 1) != 1) {
+                Drop(1);
+                return false;
+            }
+            return true;
+        }
+
+        /// Producer side. Queues as many whole frames from the start of the vector as fit in one commit and returns
+        /// how many that was, frame n gets sequence number sequenceNo + n (0 stays 0 for unsequenced sources).
+        /// Frames left over are not counted as dropped, the caller retries or gives up on them with Drop().
+        size_t PushV(const uint32_t sequenceNo, const struct iovec frames[], const size_t count)
+        {
+            const uint64_t head = m_head.load(std::memory_order_relaxed);
+            const uint64_t tail = m_tail.load(std::memory_order_acquire);
+            const size_t available = m_capacity - static_cast<size_t>(head - tail);
+
+            size_t slots = 0;
+            size_t accepted = 0;
+            for (; accepted < count; accepted++) {
+                const size_t needed = (frames[accepted].iov_len + FRAME_SIZE_MAX - 1) / FRAME_SIZE_MAX;
+                if (slots + needed > available) {
+                    break;
+                }
+                slots += needed;
+            }
+
+            if (slots == 0) {
+                return accepted;
+            }
+
+            const uint64_t now = NowNs();
+            uint64_t position = head;
+            for (size_t index = 0; index < accepted; index++) {
+                const uint8_t* data = static_cast<const uint8_t*>(frames[index].iov_base);
+                const size_t length = frames[index].iov_len;
+                for (size_t offset = 0; offset < length; offset += FRAME_SIZE_MAX) {
+                    Frame& frame = m_frames[position++ & m_mask];
+                    const size_t chunk = (length - offset < FRAME_SIZE_MAX ? length - offset : FRAME_SIZE_MAX);
+                    frame.sequenceNo = (sequenceNo == 0 ? 0 : sequenceNo + static_cast<uint32_t>(index));
+                    frame.chunk = static_cast<uint32_t>(offset / FRAME_SIZE_MAX);
+                    frame.chunks = static_cast<uint32_t>((length + FRAME_SIZE_MAX - 1) / FRAME_SIZE_MAX);
+                    frame.length = static_cast<uint32_t>(chunk);
+                    frame.enqueuedNs = now;
+                    std::memcpy(frame.data, data + offset, chunk);
+                }
+            }
+            m_head.store(head + slots, std::memory_order_release);
+
+            const uint32_t depth = static_cast<uint32_t>(head + slots - tail);
+            if (depth > m_highWaterMark.load(std::memory_order_relaxed)) {
+                m_highWaterMark.store(depth, std::memory_order_relaxed);
+            }
+            m_enqueued.fetch_add(accepted, std::memory_order_relaxed);
+            Signal();
+            return accepted;
+        }
+
+        /// Producer side. Counts frames the producer gave up on
+        void Drop(const size_t count)
+        {
+            m_dropped.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        /// Consumer side. Blocks until the producer signals or the timeout elapses. The timeout runs on the monotonic
+        /// clock, a wall clock step (NTP at boot) neither stalls nor spins the consumer.
+        void Wait(const uint32_t timeoutMs)
+        {
+#if defined(AUDIO_STAGING_SEM_CLOCKWAIT)
+            struct timespec deadline;
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+            deadline.tv_sec += timeoutMs / 1000;
+            deadline.tv_nsec += (timeoutMs % 1000) * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            while (sem_clockwait(&m_ready, CLOCK_MONOTONIC, &deadline) != 0 && errno == EINTR) {
+            }
+#else
+            std::unique_lock<std::mutex> lock{ m_readyMutex };
+            if (m_readyCond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() { return m_readyCount > 0; })) {
+                m_readyCount--;
+            }
+#endif
+        }
+
+        /// Wakes a consumer blocked in Wait()
+        void Signal()
+        {
+#if defined(AUDIO_STAGING_SEM_CLOCKWAIT)
+            sem_post(&m_ready);
+#else
+            {
+                const std::lock_guard<std::mutex> lock{ m_readyMutex };
+                m_readyCount++;
+            }
+            m_readyCond.notify_one();
+#endif
+        }
+
+        /// Consumer side. Returns the oldest frame or nullptr when the ring is empty.
+        const Frame* Front() const
+        {
+            const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail == m_head.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            return &m_frames[tail & m_mask];
+        }
+
+        /// Consumer side. Releases the frame returned by Front() once it has been committed to the SDS.
+        void Pop()
+        {
+            const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+            const uint64_t latencyUs = (NowNs() - m_frames[tail & m_mask].enqueuedNs) / 1000;
+
+            m_tail.store(tail + 1, std::memory_order_release);
+
+            const uint64_t committed = m_committed.load(std::memory_order_relaxed) + 1;
+            m_latencyUsSum += latencyUs;
+            if (committed == 1 || latencyUs < m_latencyUsMin.load(std::memory_order_relaxed)) {
+                m_latencyUsMin.store(static_cast<uint32_t>(latencyUs), std::memory_order_relaxed);
+            }
+            if (latencyUs > m_latencyUsMax.load(std::memory_order_relaxed)) {
+                m_latencyUsMax.store(static_cast<uint32_t>(latencyUs), std::memory_order_relaxed);
+            }
+            m_latencyUsAvg.store(static_cast<uint32_t>(m_latencyUsSum / committed), std::memory_order_relaxed);
+            m_committed.store(committed, std::memory_order_relaxed);
+        }
+
+        /// Safe to call from any thread
+        Stats GetStats() const
+        {
+            Stats stats;
+            stats.capacity = static_cast<uint32_t>(m_capacity);
+            stats.depth = static_cast<uint32_t>(m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire));
+            stats.highWaterMark = m_highWaterMark.load(std::memory_order_relaxed);
+            stats.enqueued = m_enqueued.load(std::memory_order_relaxed);
+            stats.dropped = m_dropped.load(std::memory_order_relaxed);
+            stats.committed = m_committed.load(std::memory_order_relaxed);
+            stats.latencyUsMin = m_latencyUsMin.load(std::memory_order_relaxed);
+            stats.latencyUsAvg = m_latencyUsAvg.load(std::memory_order_relaxed);
+            stats.latencyUsMax = m_latencyUsMax.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+    private:
+        AudioStagingQueue(size_t capacity)
+            : m_capacity{ capacity }
+            , m_mask{ capacity - 1 }
+            , m_frames{ new (std::nothrow) Frame[capacity] }
+            , m_head{ 0 }
+            , m_tail{ 0 }
+            , m_highWaterMark{ 0 }
+            , m_enqueued{ 0 }
+            , m_dropped{ 0 }
+            , m_committed{ 0 }
+            , m_latencyUsSum{ 0 }
+            , m_latencyUsMin{ 0 }
+            , m_latencyUsAvg{ 0 }
+            , m_latencyUsMax{ 0 }
+        {
+#if defined(AUDIO_STAGING_SEM_CLOCKWAIT)
+            sem_init(&m_ready, 0, 0);
+#else
+            m_readyCount = 0;
+#endif
+        }
+
+        static uint64_t NowNs()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        static constexpr size_t CACHE_LINE_SIZE = 64;
+
+        const size_t m_capacity;
+        const size_t m_mask;
+        std::unique_ptr<Frame[]> m_frames;
+#if defined(AUDIO_STAGING_SEM_CLOCKWAIT)
+        sem_t m_ready;
+#else
+        std::mutex m_readyMutex;
+        std::condition_variable m_readyCond;
+        uint32_t m_readyCount;
+#endif
+
+        // Producer and consumer indices are padded onto separate cache lines to avoid false sharing
+        uint8_t m_padHead[CACHE_LINE_SIZE];
+        std::atomic<uint64_t> m_head;
+        uint8_t m_padTail[CACHE_LINE_SIZE];
+        std::atomic<uint64_t> m_tail;
+        uint8_t m_padProducer[CACHE_LINE_SIZE];
+
+        std::atomic<uint32_t> m_highWaterMark;
+        std::atomic<uint64_t> m_enqueued;
+        std::atomic<uint64_t> m_dropped;
+        uint8_t m_padConsumer[CACHE_LINE_SIZE];
+
+        std::atomic<uint64_t> m_committed;
+        uint64_t m_latencyUsSum;
+        std::atomic<uint32_t> m_latencyUsMin;
+        std::atomic<uint32_t> m_latencyUsAvg;
+        std::atomic<uint32_t> m_latencyUsMax;
+    };
+
+} // namespace WPEFramework
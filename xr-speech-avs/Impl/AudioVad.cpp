@@ -0,0 +1,152 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "AudioVad.h"
+#include "AudioSimd.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace WPEFramework {
+
+    // Noise floor tracking, fast downwards and slow upwards so speech does not pull it up
+    static const float NOISE_FLOOR_FALL = 0.2f;
+    static const float NOISE_FLOOR_RISE = 0.01f;
+    static const float NOISE_FLOOR_MIN_DB = 20.0f;
+    static const float FRICATIVE_MARGIN_DB = 6.0f;
+
+    std::unique_ptr<AudioVad> AudioVad::create(const Config& config)
+    {
+        if (config.sampleRateHz == 0 || config.frameMs == 0 || config.sampleRateHz * config.frameMs / 1000 == 0) {
+            XLOGD_ERROR("Invalid vad configuration");
+            return nullptr;
+        }
+        return std::unique_ptr<AudioVad>(new AudioVad(config));
+    }
+
+    AudioVad::AudioVad(const Config& config)
+        : m_config(config)
+        , m_frameSamples(config.sampleRateHz * config.frameMs / 1000)
+        , m_frame(m_frameSamples)
+        , m_frameFill(0)
+        , m_noiseFloorValid(false)
+        , m_noiseFloorDb(NOISE_FLOOR_MIN_DB)
+        , m_framesProcessed(0)
+        , m_speechFrames(0)
+        , m_silenceFrames(0)
+        , m_endOfSpeech(false)
+        , m_endOfSpeechFrame(0)
+    {
+    }
+
+    void AudioVad::Reset()
+    {
+        m_frameFill = 0;
+        m_framesProcessed = 0;
+        m_speechFrames = 0;
+        m_silenceFrames = 0;
+        m_endOfSpeech = false;
+        m_endOfSpeechFrame = 0;
+    }
+
+    bool AudioVad::Process(const int16_t samples[], const size_t count)
+    {
+        bool endOfSpeech = false;
+        size_t index = 0;
+
+        // Complete a frame carried over from the previous call
+        if (m_frameFill > 0) {
+            const size_t copy = std::min(count, m_frameSamples - m_frameFill);
+            std::copy(samples, samples + copy, m_frame.begin() + m_frameFill);
+            m_frameFill += copy;
+            index = copy;
+            if (m_frameFill < m_frameSamples) {
+                return false;
+            }
+            m_frameFill = 0;
+            endOfSpeech |= ProcessFrame(m_frame.data());
+        }
+
+        // Whole frames are analysed in place
+        for (; index + m_frameSamples <= count; index += m_frameSamples) {
+            endOfSpeech |= ProcessFrame(samples + index);
+        }
+
+        m_frameFill = count - index;
+        std::copy(samples + index, samples + count, m_frame.begin());
+        return endOfSpeech;
+    }
+
+    bool AudioVad::ProcessFrame(const int16_t samples[])
+    {
+        m_framesProcessed++;
+        if (m_endOfSpeech) {
+            return false;
+        }
+
+        const float energyDb = 10.0f * log10f(static_cast<float>(AudioSimd::SumSquares(samples, m_frameSamples)) / m_frameSamples + 1.0f);
+        const uint32_t zcrPercent = AudioSimd::ZeroCrossings(samples, m_frameSamples) * 100 / m_frameSamples;
+
+        if (!m_noiseFloorValid) {
+            m_noiseFloorDb = std::max(energyDb, NOISE_FLOOR_MIN_DB);
+            m_noiseFloorValid = true;
+        }
+
+        const float thresholdDb = m_noiseFloorDb + m_config.thresholdDb;
+        const bool speech = energyDb > thresholdDb ||
+            (energyDb > thresholdDb - FRICATIVE_MARGIN_DB && zcrPercent >= m_config.zcrPercent);
+
+        if (energyDb < m_noiseFloorDb) {
+            m_noiseFloorDb += NOISE_FLOOR_FALL * (energyDb - m_noiseFloorDb);
+        } else if (!speech) {
+            m_noiseFloorDb += NOISE_FLOOR_RISE * (energyDb - m_noiseFloorDb);
+        }
+        m_noiseFloorDb = std::max(m_noiseFloorDb, NOISE_FLOOR_MIN_DB);
+
+        if (speech) {
+            m_speechFrames++;
+            m_silenceFrames = 0;
+            return false;
+        }
+
+        // Silence ahead of the speech is left to the cloud
+        if (m_speechFrames * m_config.frameMs < m_config.minSpeechMs) {
+            return false;
+        }
+        if (++m_silenceFrames * m_config.frameMs < m_config.hangoverMs) {
+            return false;
+        }
+
+        m_endOfSpeech = true;
+        m_endOfSpeechFrame = m_framesProcessed;
+        return true;
+    }
+
+    AudioVad::Stats AudioVad::GetStats() const
+    {
+        Stats stats;
+        stats.speechMs = m_speechFrames * m_config.frameMs;
+        stats.endOfSpeechMs = m_endOfSpeech ? m_endOfSpeechFrame * m_config.frameMs : 0;
+        stats.endOfSpeech = m_endOfSpeech;
+        stats.noiseFloorDb = m_noiseFloorDb;
+        return stats;
+    }
+
+} // namespace WPEFramework
@@ -0,0 +1,87 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace WPEFramework {
+
+    /// Energy and zero-crossing rate voice activity detector used as a local end-pointer. Short-term energy is
+    /// compared to an adaptive noise floor, low energy frames with a high zero-crossing rate (fricatives) still count
+    /// as speech. End of speech is declared once, after enough speech has been seen and the hangover has elapsed in
+    /// silence. Not thread safe, it is owned and driven by the SDS writer thread.
+    class AudioVad {
+    public:
+        struct Config {
+            uint32_t sampleRateHz;
+            uint32_t frameMs;
+            uint32_t thresholdDb;     ///< Energy above the noise floor that marks speech
+            uint32_t zcrPercent;      ///< Zero-crossing rate that marks unvoiced speech within 6 dB of the threshold
+            uint32_t minSpeechMs;     ///< Speech required before an end of speech can be declared
+            uint32_t hangoverMs;      ///< Trailing silence that ends the speech
+        };
+
+        struct Stats {
+            uint32_t speechMs;        ///< Speech detected in the session
+            uint32_t endOfSpeechMs;   ///< Stream time of the end of speech, 0 if none was declared
+            bool endOfSpeech;
+            float noiseFloorDb;
+        };
+
+        static std::unique_ptr<AudioVad> create(const Config& config);
+
+        AudioVad(const AudioVad&) = delete;
+        AudioVad& operator=(const AudioVad&) = delete;
+        ~AudioVad() = default;
+
+        /// Analyses 16-bit mono samples, returns true for the call that declares the end of speech
+        bool Process(const int16_t samples[], const size_t count);
+
+        /// Starts a new session, the noise floor is kept as the starting estimate
+        void Reset();
+
+        Stats GetStats() const;
+
+    private:
+        AudioVad(const Config& config);
+
+        bool ProcessFrame(const int16_t samples[]);
+
+    private:
+        const Config m_config;
+        const size_t m_frameSamples;
+        std::vector<int16_t> m_frame;
+        size_t m_frameFill;
+
+        bool m_noiseFloorValid;
+        float m_noiseFloorDb;
+        uint32_t m_framesProcessed;
+        uint32_t m_speechFrames;
+        uint32_t m_silenceFrames;
+        bool m_endOfSpeech;
+        uint32_t m_endOfSpeechFrame;
+    };
+
+} // namespace WPEFramework
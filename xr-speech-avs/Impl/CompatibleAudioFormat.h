@@ -65,6 +65,25 @@ namespace WPEFramework {
             return true;
         }
 
+        // Input formats the ingest conversion stage can bring to the settings above before they reach the SDS
+        static constexpr unsigned int CONVERTIBLE_SAMPLE_RATES_HZ[] = { 8000, 16000, 22050, 44100, 48000 };
+        static constexpr unsigned int CONVERTIBLE_MAX_CHANNELS = 4;
+
+        static bool IsConvertible(unsigned int sampleRateHz, unsigned int numChannels)
+        {
+            if (numChannels == 0 || numChannels > CONVERTIBLE_MAX_CHANNELS) {
+                XLOGD_ERROR("Unsupported number of input channels <%u>", numChannels);
+                return false;
+            }
+            for (unsigned int rate : CONVERTIBLE_SAMPLE_RATES_HZ) {
+                if (rate == sampleRateHz) {
+                    return true;
+                }
+            }
+            XLOGD_ERROR("Unsupported input sample rate <%u>", sampleRateHz);
+            return false;
+        }
+
     } // namespace AudioFormatCompatibility
 
 } // namespace WPEFramework
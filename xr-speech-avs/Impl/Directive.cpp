@@ -0,0 +1,146 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "Directive.h"
+
+namespace WPEFramework {
+
+    Directive* Directive::create(const std::string& message, const DirectiveHeader& header)
+    {
+        return new Directive(message, header);
+    }
+
+    Directive::Directive(const std::string& message, const DirectiveHeader& header)
+        : m_references(1)
+        , m_raw(message)
+        , m_fields(JoinFields(header))
+        , m_nameOffset(header.nameSpace.size + 1)
+        , m_messageIdOffset(m_nameOffset + header.name.size + 1)
+        , m_dialogRequestIdOffset(m_messageIdOffset + header.messageId.size + 1)
+        , m_json(nullptr)
+    {
+    }
+
+    std::string Directive::JoinFields(const DirectiveHeader& header)
+    {
+        std::string fields;
+        fields.reserve(header.nameSpace.size + header.name.size + header.messageId.size + header.dialogRequestId.size + 4);
+        for (const DirectiveHeader::Field* field : { &header.nameSpace, &header.name, &header.messageId, &header.dialogRequestId }) {
+            if (field->data != nullptr) {
+                fields.append(field->data, field->size);
+            }
+            fields.push_back('\0');
+        }
+        return fields;
+    }
+
+    Directive::~Directive()
+    {
+        if (m_json != nullptr) {
+            json_decref(m_json);
+        }
+    }
+
+    void Directive::AddRef() const
+    {
+        m_references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Directive::Release() const
+    {
+        if (m_references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    const json_t* Directive::Json() const
+    {
+        std::call_once(m_jsonOnce, [this]() {
+            json_error_t error;
+            m_json = json_loadb(m_raw.data(), m_raw.size(), 0, &error);
+            if (m_json == nullptr) {
+                XLOGD_ERROR("Failed to parse directive <%s.%s> line <%d> <%s>", NameSpace(), Name(), error.line, error.text);
+            }
+        });
+        return m_json;
+    }
+
+    avs_sdt_directive_t* Directive::Handle() const
+    {
+        return reinterpret_cast<avs_sdt_directive_t*>(const_cast<Directive*>(this));
+    }
+
+    Directive* Directive::FromHandle(avs_sdt_directive_t* handle)
+    {
+        return reinterpret_cast<Directive*>(handle);
+    }
+
+} // namespace WPEFramework
+
+using WPEFramework::Directive;
+
+avs_sdt_directive_t* avs_sdt_directive_ref(avs_sdt_directive_t* directive)
+{
+    if (directive != NULL) {
+        Directive::FromHandle(directive)->AddRef();
+    }
+    return directive;
+}
+
+void avs_sdt_directive_unref(avs_sdt_directive_t* directive)
+{
+    if (directive != NULL) {
+        Directive::FromHandle(directive)->Release();
+    }
+}
+
+const char* avs_sdt_directive_raw(avs_sdt_directive_t* directive, unsigned long* length)
+{
+    const std::string& raw = Directive::FromHandle(directive)->Raw();
+    if (length != NULL) {
+        *length = raw.size();
+    }
+    return raw.c_str();
+}
+
+const char* avs_sdt_directive_namespace(avs_sdt_directive_t* directive)
+{
+    return Directive::FromHandle(directive)->NameSpace();
+}
+
+const char* avs_sdt_directive_name(avs_sdt_directive_t* directive)
+{
+    return Directive::FromHandle(directive)->Name();
+}
+
+const char* avs_sdt_directive_message_id(avs_sdt_directive_t* directive)
+{
+    return Directive::FromHandle(directive)->MessageId();
+}
+
+const char* avs_sdt_directive_dialog_request_id(avs_sdt_directive_t* directive)
+{
+    return Directive::FromHandle(directive)->DialogRequestId();
+}
+
+const json_t* avs_sdt_directive_json(avs_sdt_directive_t* directive)
+{
+    return Directive::FromHandle(directive)->Json();
+}
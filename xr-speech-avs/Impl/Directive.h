@@ -0,0 +1,117 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include "../avs_sdt/avs_sdt.h"
+#include "DirectiveHeader.h"
+#include <rdkx_logger.h>
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+
+namespace WPEFramework {
+
+    /**
+     * A server directive built once and shared by every consumer (VoiceToApps, the avs_sdt directive handler)
+     * instead of each of them copying and parsing the message. It holds the raw message and its header fields, the
+     * JSON view is only parsed when a consumer asks for it. Immutable and intrusively reference counted so it can
+     * be handed through the C API as an avs_sdt_directive_t. Thread safe.
+    */
+    class Directive {
+    public:
+        /// Copies the message, the header must have been parsed from it. Returned with one reference.
+        static Directive* create(const std::string& message, const DirectiveHeader& header);
+
+        Directive(const Directive&) = delete;
+        Directive& operator=(const Directive&) = delete;
+
+        void AddRef() const;
+        void Release() const;
+
+        const std::string& Raw() const { return m_raw; }
+        const char* NameSpace() const { return m_fields.c_str(); }
+        const char* Name() const { return m_fields.c_str() + m_nameOffset; }
+        const char* MessageId() const { return m_fields.c_str() + m_messageIdOffset; }
+        const char* DialogRequestId() const { return m_fields.c_str() + m_dialogRequestIdOffset; }
+
+        /// Parsed on first use, owned by the directive and shared by every consumer, so it must not be modified.
+        /// NULL if the message is not valid JSON.
+        const json_t* Json() const;
+
+        avs_sdt_directive_t* Handle() const;
+        static Directive* FromHandle(avs_sdt_directive_t* handle);
+
+    private:
+        Directive(const std::string& message, const DirectiveHeader& header);
+        ~Directive();
+
+        static std::string JoinFields(const DirectiveHeader& header);
+
+    private:
+        mutable std::atomic<uint32_t> m_references;
+        const std::string m_raw;
+        // The header fields back to back, each NUL terminated, so they take one allocation instead of four
+        const std::string m_fields;
+        const size_t m_nameOffset;
+        const size_t m_messageIdOffset;
+        const size_t m_dialogRequestIdOffset;
+        mutable std::once_flag m_jsonOnce;
+        mutable json_t* m_json;
+    };
+
+    /// Owning reference to a Directive
+    class DirectiveRef {
+    public:
+        /// Adopts the reference returned by Directive::create
+        explicit DirectiveRef(Directive* directive = nullptr)
+            : m_directive(directive)
+        {
+        }
+        DirectiveRef(const DirectiveRef& other)
+            : m_directive(other.m_directive)
+        {
+            if (m_directive != nullptr) {
+                m_directive->AddRef();
+            }
+        }
+        DirectiveRef& operator=(DirectiveRef other)
+        {
+            std::swap(m_directive, other.m_directive);
+            return *this;
+        }
+        ~DirectiveRef()
+        {
+            if (m_directive != nullptr) {
+                m_directive->Release();
+            }
+        }
+
+        const Directive* operator->() const { return m_directive; }
+        const Directive* get() const { return m_directive; }
+        explicit operator bool() const { return m_directive != nullptr; }
+
+    private:
+        Directive* m_directive;
+    };
+
+} // namespace WPEFramework
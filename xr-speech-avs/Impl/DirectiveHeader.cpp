@@ -0,0 +1,196 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "DirectiveHeader.h"
+
+namespace WPEFramework {
+
+    namespace {
+
+        class Scanner {
+        public:
+            Scanner(const char* data, const size_t length)
+                : m_position(data)
+                , m_end(data + length)
+            {
+            }
+
+            void SkipWhitespace()
+            {
+                while (m_position < m_end && (*m_position == ' ' || *m_position == '\n' || *m_position == '\r' || *m_position == '\t')) {
+                    m_position++;
+                }
+            }
+
+            bool Consume(const char expected)
+            {
+                SkipWhitespace();
+                if (m_position < m_end && *m_position == expected) {
+                    m_position++;
+                    return true;
+                }
+                return false;
+            }
+
+            bool Peek(const char expected)
+            {
+                SkipWhitespace();
+                return m_position < m_end && *m_position == expected;
+            }
+
+            // Jumps from quote to quote, a quote only closes the string after an even number of backslashes
+            bool String(DirectiveHeader::Field& field)
+            {
+                if (!Consume('"')) {
+                    return false;
+                }
+                const char* begin = m_position;
+                for (;;) {
+                    const char* quote = static_cast<const char*>(std::memchr(m_position, '"', m_end - m_position));
+                    if (quote == nullptr) {
+                        return false;
+                    }
+                    size_t backslashes = 0;
+                    while (quote - backslashes > begin && quote[-1 - static_cast<ptrdiff_t>(backslashes)] == '\\') {
+                        backslashes++;
+                    }
+                    m_position = quote + 1;
+                    if (backslashes % 2 == 0) {
+                        field.data = begin;
+                        field.size = quote - begin;
+                        return true;
+                    }
+                }
+            }
+
+            // Any value, containers are skipped without recursion
+            bool SkipValue()
+            {
+                DirectiveHeader::Field ignored;
+                SkipWhitespace();
+                if (m_position == m_end) {
+                    return false;
+                }
+                if (*m_position == '"') {
+                    return String(ignored);
+                }
+                if (*m_position != '{' && *m_position != '[') {
+                    while (m_position < m_end && *m_position != ',' && *m_position != '}' && *m_position != ']') {
+                        m_position++;
+                    }
+                    return m_position < m_end;
+                }
+
+                size_t depth = 0;
+                while (m_position < m_end) {
+                    const char c = *m_position;
+                    if (c == '"') {
+                        if (!String(ignored)) {
+                            return false;
+                        }
+                        continue;
+                    }
+                    m_position++;
+                    if (c == '{' || c == '[') {
+                        depth++;
+                    } else if ((c == '}' || c == ']') && --depth == 0) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+        private:
+            const char* m_position;
+            const char* m_end;
+        };
+
+        // Calls onKey for each key of the object, it has to consume the value. Stops early if onKey returns false.
+        template <typename OnKey>
+        bool Members(Scanner& scanner, OnKey onKey)
+        {
+            if (!scanner.Consume('{')) {
+                return false;
+            }
+            if (scanner.Consume('}')) {
+                return true;
+            }
+            do {
+                DirectiveHeader::Field key;
+                if (!scanner.String(key) || !scanner.Consume(':')) {
+                    return false;
+                }
+                bool more = true;
+                if (!onKey(key, more)) {
+                    return false;
+                }
+                if (!more) {
+                    return true;
+                }
+            } while (scanner.Consume(','));
+            return scanner.Consume('}');
+        }
+
+    } // namespace
+
+    bool DirectiveHeader::Parse(const char* message, const size_t length)
+    {
+        nameSpace = Field{ nullptr, 0 };
+        name = Field{ nullptr, 0 };
+        messageId = Field{ nullptr, 0 };
+        dialogRequestId = Field{ nullptr, 0 };
+
+        Scanner scanner(message, length);
+        bool headerSeen = false;
+
+        auto onHeaderKey = [&](const Field& key, bool&) {
+            Field* target = key == "namespace" ? &nameSpace
+                : key == "name" ? &name
+                : key == "messageId" ? &messageId
+                : key == "dialogRequestId" ? &dialogRequestId
+                : nullptr;
+            if (target != nullptr && scanner.Peek('"')) {
+                return scanner.String(*target);
+            }
+            return scanner.SkipValue();
+        };
+        auto onDirectiveKey = [&](const Field& key, bool& more) {
+            if (key == "header") {
+                headerSeen = true;
+                more = false;
+                return Members(scanner, onHeaderKey);
+            }
+            return scanner.SkipValue();
+        };
+        auto onMessageKey = [&](const Field& key, bool& more) {
+            if (key == "directive") {
+                more = false;
+                return Members(scanner, onDirectiveKey);
+            }
+            return scanner.SkipValue();
+        };
+
+        if (!Members(scanner, onMessageKey)) {
+            return false;
+        }
+        return headerSeen && !nameSpace.empty() && !name.empty();
+    }
+
+} // namespace WPEFramework
@@ -0,0 +1,57 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstring>
+#include <stddef.h>
+#include <string>
+
+namespace WPEFramework {
+
+    /**
+     * Header fields of an AVS directive message, pulled in a single pass without building a DOM. The scan stops
+     * as soon as directive.header is closed, so a payload that follows the header is never looked at, and a payload
+     * ahead of it is skipped string by string. Key order and whitespace do not matter. Values point into the
+     * message and are not unescaped, they are only valid as long as the message is.
+    */
+    struct DirectiveHeader {
+        struct Field {
+            const char* data;
+            size_t size;
+
+            bool operator==(const char* text) const
+            {
+                return data != nullptr && std::strncmp(data, text, size) == 0 && text[size] == '\0';
+            }
+            bool empty() const { return size == 0; }
+            std::string str() const { return data != nullptr ? std::string(data, size) : std::string(); }
+        };
+
+        Field nameSpace;
+        Field name;
+        Field messageId;
+        Field dialogRequestId;
+
+        /// Returns false if the message is not a directive with a namespace and a name
+        bool Parse(const char* message, const size_t length);
+    };
+
+} // namespace WPEFramework
@@ -0,0 +1,185 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "DispatchQueue.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace WPEFramework {
+
+    static const size_t WORKERS_MAX = 4;
+
+    static uint64_t NowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static size_t QueueOf(const DispatchQueue::Priority priority)
+    {
+        return priority == DispatchQueue::Priority::HIGH ? 0 : 1;
+    }
+
+    std::unique_ptr<DispatchQueue> DispatchQueue::create(const Config& config)
+    {
+        if (config.capacity == 0 || config.workers == 0 || config.workers > WORKERS_MAX) {
+            XLOGD_ERROR("Invalid dispatch queue configuration");
+            return nullptr;
+        }
+        return std::unique_ptr<DispatchQueue>(new DispatchQueue(config));
+    }
+
+    DispatchQueue::DispatchQueue(const Config& config)
+        : m_config(config)
+        , m_running(true)
+        , m_stats()
+        , m_waitUsTotal(0)
+        , m_dispatchUsTotal(0)
+    {
+        for (size_t index = 0; index < config.workers; index++) {
+            m_workers.emplace_back(&DispatchQueue::Worker, this);
+        }
+    }
+
+    DispatchQueue::~DispatchQueue()
+    {
+        {
+            const std::lock_guard<std::mutex> lock{ m_mutex };
+            m_running = false;
+            const size_t discarded = Depth();
+            if (discarded > 0) {
+                XLOGD_WARN("Discarding <%zu> queued dispatches", discarded);
+            }
+            m_queues[0].clear();
+            m_queues[1].clear();
+        }
+        m_ready.notify_all();
+        for (auto& worker : m_workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    bool DispatchQueue::Post(const Priority priority, const std::string& target, Task task)
+    {
+        std::deque<Job>& queue = m_queues[QueueOf(priority)];
+        Job job;
+        job.target = target;
+        job.task = std::move(task);
+        job.postedNs = NowNs();
+
+        {
+            const std::lock_guard<std::mutex> lock{ m_mutex };
+            if (Depth() >= m_config.capacity) {
+                std::deque<Job>& normal = m_queues[QueueOf(Priority::NORMAL)];
+                if (priority == Priority::HIGH && !normal.empty()) {
+                    XLOGD_WARN("Dispatch queue full, dropping <%s> for <%s>", normal.front().target.c_str(), target.c_str());
+                    normal.pop_front();
+                } else if (m_config.overflow == OverflowPolicy::DROP_OLDEST && !queue.empty()) {
+                    XLOGD_WARN("Dispatch queue full, dropping the oldest <%s>", queue.front().target.c_str());
+                    queue.pop_front();
+                } else {
+                    XLOGD_WARN("Dispatch queue full, dropping <%s>", target.c_str());
+                    m_stats.dropped++;
+                    return false;
+                }
+                m_stats.dropped++;
+            }
+            queue.push_back(std::move(job));
+            m_stats.posted++;
+        }
+        // Any idle worker may be the one able to take it, the others could be held by a busy target
+        m_ready.notify_all();
+        return true;
+    }
+
+    DispatchQueue::Stats DispatchQueue::GetStats() const
+    {
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        Stats stats = m_stats;
+        stats.depth = static_cast<uint32_t>(Depth());
+        if (stats.dispatched > 0) {
+            stats.waitUsAvg = static_cast<uint32_t>(m_waitUsTotal / stats.dispatched);
+            stats.dispatchUsAvg = static_cast<uint32_t>(m_dispatchUsTotal / stats.dispatched);
+        }
+        return stats;
+    }
+
+    size_t DispatchQueue::Depth() const
+    {
+        return m_queues[0].size() + m_queues[1].size();
+    }
+
+    bool DispatchQueue::IsBusy(const std::string& target) const
+    {
+        return std::find(m_busyTargets.begin(), m_busyTargets.end(), target) != m_busyTargets.end();
+    }
+
+    // The first task whose target is neither running nor has an earlier task waiting
+    bool DispatchQueue::TakeRunnable(Job& job)
+    {
+        std::vector<std::string> skipped;
+        for (auto& queue : m_queues) {
+            for (auto it = queue.begin(); it != queue.end(); ++it) {
+                if (IsBusy(it->target) || std::find(skipped.begin(), skipped.end(), it->target) != skipped.end()) {
+                    skipped.push_back(it->target);
+                    continue;
+                }
+                job = std::move(*it);
+                queue.erase(it);
+                m_busyTargets.push_back(job.target);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void DispatchQueue::Worker()
+    {
+        std::unique_lock<std::mutex> lock{ m_mutex };
+        while (m_running) {
+            Job job;
+            if (!TakeRunnable(job)) {
+                m_ready.wait(lock);
+                continue;
+            }
+            lock.unlock();
+
+            const uint64_t startNs = NowNs();
+            job.task();
+            const uint64_t endNs = NowNs();
+            const uint32_t waitUs = static_cast<uint32_t>((startNs - job.postedNs) / 1000);
+            const uint32_t dispatchUs = static_cast<uint32_t>((endNs - startNs) / 1000);
+            XLOGD_DEBUG("Dispatched <%s> wait <%u us> dispatch <%u us>", job.target.c_str(), waitUs, dispatchUs);
+
+            lock.lock();
+            m_busyTargets.erase(std::find(m_busyTargets.begin(), m_busyTargets.end(), job.target));
+            m_stats.dispatched++;
+            m_waitUsTotal += waitUs;
+            m_dispatchUsTotal += dispatchUs;
+            m_stats.waitUsMax = std::max(m_stats.waitUsMax, waitUs);
+            m_stats.dispatchUsMax = std::max(m_stats.dispatchUsMax, dispatchUs);
+            // Tasks of this target may have been passed over while it was running
+            m_ready.notify_all();
+        }
+    }
+
+} // namespace WPEFramework
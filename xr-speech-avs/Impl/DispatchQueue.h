@@ -0,0 +1,113 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace WPEFramework {
+
+    /**
+     * Bounded, prioritized task queue served by a small worker pool, used to take blocking VoiceToApps calls
+     * off the SDK observer threads. HIGH priority tasks are served first. Tasks of the same target run one at a
+     * time in the order they were posted, tasks of different targets may run in parallel. When the queue is full
+     * a HIGH task evicts the oldest NORMAL one, otherwise the overflow policy decides. The queue wait and run time
+     * of each task are logged and aggregated. Tasks still queued at destruction are discarded. Thread safe.
+    */
+    class DispatchQueue {
+    public:
+        enum class Priority : uint8_t {
+            HIGH,
+            NORMAL
+        };
+
+        enum class OverflowPolicy : uint8_t {
+            DROP_OLDEST,    ///< Evict the oldest task of the same priority
+            DROP_NEWEST     ///< Refuse the new task
+        };
+
+        struct Config {
+            size_t capacity;
+            size_t workers;
+            OverflowPolicy overflow;
+        };
+
+        struct Stats {
+            uint64_t posted;
+            uint64_t dispatched;
+            uint64_t dropped;
+            uint32_t depth;
+            uint32_t waitUsAvg;
+            uint32_t waitUsMax;
+            uint32_t dispatchUsAvg;
+            uint32_t dispatchUsMax;
+        };
+
+        using Task = std::function<void()>;
+
+        static std::unique_ptr<DispatchQueue> create(const Config& config);
+
+        DispatchQueue(const DispatchQueue&) = delete;
+        DispatchQueue& operator=(const DispatchQueue&) = delete;
+        ~DispatchQueue();
+
+        /// Returns false if the task was refused by the overflow policy
+        bool Post(const Priority priority, const std::string& target, Task task);
+
+        Stats GetStats() const;
+
+    private:
+        struct Job {
+            std::string target;
+            Task task;
+            uint64_t postedNs;
+        };
+
+        DispatchQueue(const Config& config);
+
+        void Worker();
+        bool TakeRunnable(Job& job);
+        bool IsBusy(const std::string& target) const;
+        size_t Depth() const;
+
+    private:
+        const Config m_config;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_ready;
+        std::deque<Job> m_queues[2];
+        std::vector<std::string> m_busyTargets;
+        bool m_running;
+        Stats m_stats;
+        uint64_t m_waitUsTotal;
+        uint64_t m_dispatchUsTotal;
+        std::vector<std::thread> m_workers;
+    };
+
+} // namespace WPEFramework
@@ -0,0 +1,145 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "FlightRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace WPEFramework {
+
+    using namespace FlightRecorderFormat;
+
+    static const size_t MIN_SLOTS = 64;
+    static const std::string PREVIOUS_SUFFIX(".prev");
+
+    std::shared_ptr<FlightRecorder> FlightRecorder::instance()
+    {
+        // Never destroyed, SDK threads keep recording while static destructors run at shutdown
+        static std::shared_ptr<FlightRecorder>* singleFlightRecorder = new std::shared_ptr<FlightRecorder>(new FlightRecorder);
+        return *singleFlightRecorder;
+    }
+
+    FlightRecorder::FlightRecorder()
+        : m_header(nullptr)
+        , m_slots(nullptr)
+        , m_mask(0)
+    {
+    }
+
+    // The mapping is left in place for the life of the process, a late Record() must never touch unmapped memory
+    FlightRecorder::~FlightRecorder()
+    {
+    }
+
+    bool FlightRecorder::Open(const std::string& path, const size_t sizeBytes)
+    {
+        if (m_header.load() != nullptr) {
+            XLOGD_ERROR("Flight recorder already open");
+            return false;
+        }
+
+        // Power of two so sequence numbers map to slots with a mask
+        size_t slotCount = MIN_SLOTS;
+        while ((slotCount << 1) * sizeof(Slot) + sizeof(Header) <= sizeBytes) {
+            slotCount <<= 1;
+        }
+        const size_t mappedSize = sizeof(Header) + slotCount * sizeof(Slot);
+
+        // Keep what the previous run recorded, it is what is needed after a crash
+        if (access(path.c_str(), F_OK) == 0 && rename(path.c_str(), (path + PREVIOUS_SUFFIX).c_str()) != 0) {
+            XLOGD_WARN("Failed to keep the previous flight recorder file <%s>", path.c_str());
+        }
+
+        const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            XLOGD_ERROR("Failed to open the flight recorder file <%s>", path.c_str());
+            return false;
+        }
+        if (ftruncate(fd, mappedSize) != 0) {
+            XLOGD_ERROR("Failed to size the flight recorder file <%s>", path.c_str());
+            close(fd);
+            return false;
+        }
+        void* mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            XLOGD_ERROR("Failed to map the flight recorder file <%s>", path.c_str());
+            return false;
+        }
+
+        struct timespec realtime, monotonic;
+        clock_gettime(CLOCK_REALTIME, &realtime);
+        clock_gettime(CLOCK_MONOTONIC, &monotonic);
+
+        // The file is new and zero filled, every slot starts out invalid
+        Header* header = static_cast<Header*>(mapped);
+        header->magic = MAGIC;
+        header->version = VERSION;
+        header->slotSize = sizeof(Slot);
+        header->slotCount = slotCount;
+        header->pid = getpid();
+        header->realtimeNs = static_cast<int64_t>(realtime.tv_sec) * 1000000000LL + realtime.tv_nsec;
+        header->monotonicNs = static_cast<int64_t>(monotonic.tv_sec) * 1000000000LL + monotonic.tv_nsec;
+        header->head.store(0, std::memory_order_relaxed);
+
+        m_slots = reinterpret_cast<Slot*>(header + 1);
+        m_mask = slotCount - 1;
+        m_header.store(header, std::memory_order_release);
+
+        XLOGD_INFO("Flight recorder <%s> slots <%zu>", path.c_str(), slotCount);
+        return true;
+    }
+
+    void FlightRecorder::Record(const Type type, const uint32_t value, const void* payload, const size_t length)
+    {
+        Header* header = m_header.load(std::memory_order_acquire);
+        if (header == nullptr) {
+            return;
+        }
+
+        const uint64_t sequence = header->head.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = m_slots[sequence & m_mask];
+
+        // Invalidate first so a crash half way through never leaves a slot that decodes as another event
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        slot.type = static_cast<uint16_t>(type);
+        slot.value = value;
+        slot.length = static_cast<uint16_t>(std::min(length, PAYLOAD_SIZE));
+        if (slot.length > 0) {
+            std::memcpy(slot.payload, payload, slot.length);
+        }
+
+        slot.sequence.store(sequence + 1, std::memory_order_release);
+    }
+
+    void FlightRecorder::RecordText(const Type type, const uint32_t value, const char* text)
+    {
+        Record(type, value, text, text != nullptr ? strnlen(text, PAYLOAD_SIZE) : 0);
+    }
+
+} // namespace WPEFramework
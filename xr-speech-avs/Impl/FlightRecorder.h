@@ -0,0 +1,66 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include "FlightRecorderFormat.h"
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+namespace WPEFramework {
+
+    /**
+     * Binary flight recorder in a memory mapped file. Appends are lock-free and never block, the oldest
+     * slots are overwritten once the ring is full. The pages belong to the file, so whatever was recorded
+     * survives a crash or a watchdog kill and can be decoded offline with avs-flight-decoder. The file of
+     * the previous run is kept with a .prev suffix. Records are dropped until Open succeeds. Thread safe.
+    */
+    class FlightRecorder {
+    public:
+        using Type = FlightRecorderFormat::Type;
+
+        FlightRecorder(const FlightRecorder&) = delete;
+        FlightRecorder& operator=(const FlightRecorder&) = delete;
+        ~FlightRecorder();
+
+        static std::shared_ptr<FlightRecorder> instance();
+
+        /// Maps sizeBytes of path, can only be done once
+        bool Open(const std::string& path, const size_t sizeBytes);
+
+        void Record(const Type type, const uint32_t value, const void* payload = nullptr, const size_t length = 0);
+        /// Text is truncated to the payload size
+        void RecordText(const Type type, const uint32_t value, const char* text);
+
+    private:
+        FlightRecorder();
+
+    private:
+        std::atomic<FlightRecorderFormat::Header*> m_header;
+        FlightRecorderFormat::Slot* m_slots;
+        uint64_t m_mask;
+    };
+
+} // namespace WPEFramework
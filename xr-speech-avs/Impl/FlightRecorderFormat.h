@@ -0,0 +1,87 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace WPEFramework {
+
+    /**
+     * On-disk layout of the flight recorder file, shared by the recorder and the offline decoder.
+     * A header is followed by a power of two number of fixed size slots used as a ring.
+    */
+    namespace FlightRecorderFormat {
+
+        static constexpr uint64_t MAGIC = 0x3152544C46535641ULL; ///< "AVSFLTR1"
+        static constexpr uint32_t VERSION = 1;
+        static constexpr size_t PAYLOAD_SIZE = 40;
+
+        enum class Type : uint16_t {
+            SESSION = 1,    ///< value is the voice_trace_event_t
+            INGEST_STATS,   ///< payload is an IngestStats
+            DIALOG_STATE,   ///< value is the DialogUXState
+            DIRECTIVE,      ///< payload is the "Namespace.Name" text
+            SDS_OVERRUN,    ///< value is the SDS writer error, payload the words refused as uint64_t
+            STAGING_DROP,   ///< value is the number of frames dropped by the staging queue
+            ERROR           ///< value is the SDK log level, payload the start of the message
+        };
+
+        struct IngestStats {
+            uint64_t framesEnqueued;
+            uint64_t framesDropped;
+            uint64_t framesCommitted;
+            uint32_t depth;
+            uint32_t framesLost;
+            uint32_t latencyUsMax;
+            uint32_t jitterMs;
+        };
+
+        struct Header {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t slotSize;
+            uint64_t slotCount;
+            uint64_t pid;
+            int64_t realtimeNs;                ///< CLOCK_REALTIME when the file was opened
+            int64_t monotonicNs;               ///< CLOCK_MONOTONIC at the same instant, slot times use this clock
+            std::atomic<uint64_t> head;        ///< Sequence number of the next slot to write
+            uint64_t reserved;
+        };
+
+        /// A slot is valid when sequence is its sequence number + 1, 0 while it is being written
+        struct Slot {
+            std::atomic<uint64_t> sequence;
+            uint64_t timeNs;
+            uint16_t type;
+            uint16_t length;
+            uint32_t value;
+            uint8_t payload[PAYLOAD_SIZE];
+        };
+
+        static_assert(sizeof(IngestStats) == PAYLOAD_SIZE, "Ingest stats must fill a payload");
+        static_assert(sizeof(Header) == 64, "Unexpected flight recorder header size");
+        static_assert(sizeof(Slot) == 64, "Unexpected flight recorder slot size");
+
+    } // namespace FlightRecorderFormat
+
+} // namespace WPEFramework
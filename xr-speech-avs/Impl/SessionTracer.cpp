@@ -0,0 +1,234 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "SessionTracer.h"
+
+#include <chrono>
+#include <cstring>
+#include <sstream>
+
+namespace WPEFramework {
+
+    static const size_t RECORDS_KEPT = 16;
+    // Leaves room for the AudioPlayer to start playing once the dialog is back to IDLE
+    static const uint64_t IDLE_GRACE_NS = 5000000000ULL;
+
+    static uint64_t NowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static uint64_t FirstTime(const SessionTracer::Record& record, const SessionTracer::Event event)
+    {
+        for (size_t index = 0; index < record.eventCount; index++) {
+            if (record.events[index].event == event) {
+                return record.events[index].timeNs;
+            }
+        }
+        return 0;
+    }
+
+    static int32_t PhaseMs(const uint64_t beginNs, const uint64_t endNs)
+    {
+        if (beginNs == 0 || endNs == 0 || endNs < beginNs) {
+            return -1;
+        }
+        return static_cast<int32_t>((endNs - beginNs) / 1000000);
+    }
+
+    std::shared_ptr<SessionTracer> SessionTracer::instance()
+    {
+        static std::shared_ptr<SessionTracer> singleSessionTracer = std::shared_ptr<SessionTracer>(new SessionTracer);
+        return singleSessionTracer;
+    }
+
+    const char* SessionTracer::EventName(const Event event)
+    {
+        switch (event) {
+        case Event::SESSION_BEGIN:    return "session_begin";
+        case Event::STREAM_BEGIN:     return "stream_begin";
+        case Event::STREAM_KWD:       return "stream_kwd";
+        case Event::FIRST_SDS_WRITE:  return "first_sds_write";
+        case Event::STREAM_END:       return "stream_end";
+        case Event::SESSION_END:      return "session_end";
+        case Event::DIALOG_IDLE:      return "dialog_idle";
+        case Event::DIALOG_LISTENING: return "dialog_listening";
+        case Event::DIALOG_EXPECTING: return "dialog_expecting";
+        case Event::DIALOG_THINKING:  return "dialog_thinking";
+        case Event::DIALOG_SPEAKING:  return "dialog_speaking";
+        case Event::DIALOG_FINISHED:  return "dialog_finished";
+        case Event::SPEAK_DIRECTIVE:  return "speak_directive";
+        case Event::FIRST_PLAYING:    return "first_playing";
+        }
+        return "unknown";
+    }
+
+    SessionTracer::SessionTracer()
+        : m_open(false)
+        , m_idleNs(0)
+        , m_current()
+        , m_records(RECORDS_KEPT)
+        , m_recordHead(0)
+        , m_recordCount(0)
+    {
+    }
+
+    void SessionTracer::BeginSession(const std::string& sessionId, const uint64_t timeNs)
+    {
+        const uint64_t beginNs = timeNs != 0 ? timeNs : NowNs();
+
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        if (m_open) {
+            Close();
+        }
+        std::memset(&m_current, 0, sizeof(m_current));
+        std::strncpy(m_current.sessionId, sessionId.c_str(), SESSION_ID_LENGTH - 1);
+        m_current.beginNs = beginNs;
+        m_current.events[m_current.eventCount++] = TraceEvent{ Event::SESSION_BEGIN, beginNs };
+        m_idleNs = 0;
+        m_open = true;
+    }
+
+    void SessionTracer::Trace(const Event event, const uint64_t timeNs)
+    {
+        const uint64_t nowNs = NowNs();
+        const uint64_t eventNs = timeNs != 0 ? timeNs : nowNs;
+
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        CloseExpired(nowNs);
+        if (!m_open || m_current.eventCount == EVENTS_MAX) {
+            return;
+        }
+        if ((event == Event::FIRST_SDS_WRITE || event == Event::FIRST_PLAYING) && FirstTime(m_current, event) != 0) {
+            return;
+        }
+        m_current.events[m_current.eventCount++] = TraceEvent{ event, eventNs };
+
+        // The interaction is over once the dialog is idle after the stream, a new turn re-opens it
+        if (event == Event::DIALOG_IDLE) {
+            if (FirstTime(m_current, Event::STREAM_END) != 0 || FirstTime(m_current, Event::SESSION_END) != 0) {
+                m_idleNs = eventNs;
+            }
+        } else if (event == Event::DIALOG_LISTENING || event == Event::DIALOG_EXPECTING) {
+            m_idleNs = 0;
+        }
+    }
+
+    bool SessionTracer::GetLastRecord(Record& record)
+    {
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        CloseExpired(NowNs());
+        if (m_recordCount == 0) {
+            return false;
+        }
+        record = m_records[(m_recordHead + RECORDS_KEPT - 1) % RECORDS_KEPT];
+        return true;
+    }
+
+    std::string SessionTracer::ExportChromeTrace()
+    {
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        CloseExpired(NowNs());
+
+        std::ostringstream json;
+        json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        for (size_t count = 0; count < m_recordCount; count++) {
+            const size_t slot = (m_recordHead + RECORDS_KEPT - m_recordCount + count) % RECORDS_KEPT;
+            const Record& record = m_records[slot];
+            // One track per session, named after the session id
+            const size_t tid = count + 1;
+            json << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+                 << ",\"args\":{\"name\":\"" << record.sessionId << "\"}}";
+            first = false;
+
+            for (size_t index = 0; index < record.eventCount; index++) {
+                json << ",{\"name\":\"" << EventName(record.events[index].event) << "\",\"cat\":\"voice\",\"ph\":\"i\",\"s\":\"t\",\"ts\":"
+                     << record.events[index].timeNs / 1000 << ",\"pid\":1,\"tid\":" << tid << "}";
+            }
+
+            const uint64_t streamEndNs = FirstTime(record, Event::STREAM_END);
+            const uint64_t thinkingNs = FirstTime(record, Event::DIALOG_THINKING);
+            const struct {
+                const char* name;
+                uint64_t beginNs;
+                int32_t durationMs;
+            } phases[] = {
+                { "first_write", FirstTime(record, Event::STREAM_BEGIN), record.phases.firstWriteMs },
+                { "listen", FirstTime(record, Event::STREAM_BEGIN), record.phases.listenMs },
+                { "end_to_think", streamEndNs, record.phases.endToThinkMs },
+                { "think", thinkingNs, record.phases.thinkMs },
+                { "speak_directive", streamEndNs, record.phases.speakDirectiveMs },
+                { "first_audio", streamEndNs, record.phases.firstAudioMs },
+                { "total", record.beginNs, record.phases.totalMs }
+            };
+            for (const auto& phase : phases) {
+                if (phase.durationMs >= 0) {
+                    json << ",{\"name\":\"" << phase.name << "\",\"cat\":\"phase\",\"ph\":\"X\",\"ts\":" << phase.beginNs / 1000
+                         << ",\"dur\":" << static_cast<uint64_t>(phase.durationMs) * 1000 << ",\"pid\":1,\"tid\":" << tid << "}";
+                }
+            }
+        }
+        json << "]}";
+        return json.str();
+    }
+
+    void SessionTracer::CloseExpired(const uint64_t nowNs)
+    {
+        if (m_open && m_idleNs != 0 && nowNs > m_idleNs + IDLE_GRACE_NS) {
+            Close();
+        }
+    }
+
+    void SessionTracer::Close()
+    {
+        Record& record = m_current;
+        const uint64_t streamBeginNs = FirstTime(record, Event::STREAM_BEGIN);
+        const uint64_t streamEndNs = FirstTime(record, Event::STREAM_END);
+        const uint64_t thinkingNs = FirstTime(record, Event::DIALOG_THINKING);
+        const uint64_t speakingNs = FirstTime(record, Event::DIALOG_SPEAKING);
+        const uint64_t playingNs = FirstTime(record, Event::FIRST_PLAYING);
+        uint64_t firstAudioNs = speakingNs;
+        if (playingNs != 0 && (firstAudioNs == 0 || playingNs < firstAudioNs)) {
+            firstAudioNs = playingNs;
+        }
+
+        record.phases.firstWriteMs = PhaseMs(streamBeginNs, FirstTime(record, Event::FIRST_SDS_WRITE));
+        record.phases.listenMs = PhaseMs(streamBeginNs, streamEndNs);
+        record.phases.endToThinkMs = PhaseMs(streamEndNs, thinkingNs);
+        record.phases.thinkMs = PhaseMs(thinkingNs, speakingNs);
+        record.phases.speakDirectiveMs = PhaseMs(streamEndNs, FirstTime(record, Event::SPEAK_DIRECTIVE));
+        record.phases.firstAudioMs = PhaseMs(streamEndNs, firstAudioNs);
+        record.phases.totalMs = PhaseMs(record.beginNs, record.events[record.eventCount - 1].timeNs);
+
+        XLOGD_INFO("Session <%s> first write <%d> listen <%d> end to think <%d> think <%d> speak directive <%d> first audio <%d> total <%d> ms",
+            record.sessionId, record.phases.firstWriteMs, record.phases.listenMs, record.phases.endToThinkMs, record.phases.thinkMs,
+            record.phases.speakDirectiveMs, record.phases.firstAudioMs, record.phases.totalMs);
+
+        m_records[m_recordHead] = record;
+        m_recordHead = (m_recordHead + 1) % RECORDS_KEPT;
+        if (m_recordCount < RECORDS_KEPT) {
+            m_recordCount++;
+        }
+        m_open = false;
+        m_idleNs = 0;
+    }
+
+} // namespace WPEFramework
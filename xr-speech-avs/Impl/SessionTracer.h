@@ -0,0 +1,118 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace WPEFramework {
+
+    /// In-process timeline of voice sessions. Events from xrsr (through avs_sdt), the SDS writer and the SDK
+    /// observers are stamped on the steady clock and collected per session id. A session is closed when the next
+    /// one begins or a while after the dialog returned to IDLE. Its phase latencies are then derived, logged and
+    /// kept with its events for export as records or Chrome trace JSON. Thread safe.
+    class SessionTracer {
+    public:
+        enum class Event : uint8_t {
+            SESSION_BEGIN,
+            STREAM_BEGIN,
+            STREAM_KWD,
+            FIRST_SDS_WRITE,
+            STREAM_END,
+            SESSION_END,
+            DIALOG_IDLE,
+            DIALOG_LISTENING,
+            DIALOG_EXPECTING,
+            DIALOG_THINKING,
+            DIALOG_SPEAKING,
+            DIALOG_FINISHED,
+            SPEAK_DIRECTIVE,
+            FIRST_PLAYING
+        };
+
+        static constexpr size_t SESSION_ID_LENGTH = 37;   ///< Text UUID including the terminator
+        static constexpr size_t EVENTS_MAX = 48;
+
+        struct TraceEvent {
+            Event event;
+            uint64_t timeNs;
+        };
+
+        /// Phase latencies in milliseconds, -1 when an endpoint of the phase was not seen
+        struct Phases {
+            int32_t firstWriteMs;     ///< Stream begin to the first audio in the SDS
+            int32_t listenMs;         ///< Stream begin to stream end
+            int32_t endToThinkMs;     ///< Stream end to THINKING
+            int32_t thinkMs;          ///< THINKING to SPEAKING
+            int32_t speakDirectiveMs; ///< Stream end to the Speak directive
+            int32_t firstAudioMs;     ///< Stream end to SPEAKING or the first PLAYING, whichever comes first
+            int32_t totalMs;          ///< Session begin to the last event
+        };
+
+        struct Record {
+            char sessionId[SESSION_ID_LENGTH];
+            uint64_t beginNs;
+            Phases phases;
+            size_t eventCount;
+            TraceEvent events[EVENTS_MAX];
+        };
+
+        SessionTracer(const SessionTracer&) = delete;
+        SessionTracer& operator=(const SessionTracer&) = delete;
+
+        static std::shared_ptr<SessionTracer> instance();
+
+        static const char* EventName(const Event event);
+
+        /// Opens a new session, the previous one is closed
+        void BeginSession(const std::string& sessionId, const uint64_t timeNs);
+
+        /// Adds an event to the open session, timeNs of 0 stamps it now
+        void Trace(const Event event, const uint64_t timeNs = 0);
+
+        /// Last closed session
+        bool GetLastRecord(Record& record);
+
+        /// Closed sessions as Chrome trace JSON (chrome://tracing, Perfetto)
+        std::string ExportChromeTrace();
+
+    private:
+        SessionTracer();
+
+        void CloseExpired(const uint64_t nowNs);
+        void Close();
+
+    private:
+        std::mutex m_mutex;
+        bool m_open;
+        uint64_t m_idleNs;
+        Record m_current;
+        std::vector<Record> m_records;
+        size_t m_recordHead;
+        size_t m_recordCount;
+    };
+
+} // namespace WPEFramework
@@ -0,0 +1,179 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "RecognizeController.h"
+
+namespace WPEFramework {
+
+    using namespace alexaClientSDK::avsCommon::sdkInterfaces;
+
+    std::unique_ptr<RecognizeController> RecognizeController::create(std::shared_ptr<alexaSmartScreenSDK::smartScreenClient::SmartScreenClient> client,
+        alexaClientSDK::capabilityAgents::aip::AudioProvider holdAudioProvider)
+    {
+        if (!client) {
+            XLOGD_ERROR("Invalid client passed to RecognizeController");
+            return nullptr;
+        }
+        return std::unique_ptr<RecognizeController>(new RecognizeController(client, holdAudioProvider));
+    }
+
+    RecognizeController::RecognizeController(std::shared_ptr<alexaSmartScreenSDK::smartScreenClient::SmartScreenClient> client,
+        alexaClientSDK::capabilityAgents::aip::AudioProvider holdAudioProvider)
+        : m_client(client)
+        , m_holdAudioProvider(holdAudioProvider)
+        , m_mode(Mode::NONE)
+        , m_dialogState(DialogUXState::IDLE)
+        , m_dialogStateSince(std::chrono::steady_clock::now())
+        , m_stats()
+    {
+    }
+
+    bool RecognizeController::Start()
+    {
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        if (m_mode != Mode::NONE) {
+            XLOGD_DEBUG("Recognize already started");
+            m_stats.ignored++;
+            return true;
+        }
+
+        PreemptDialog();
+        m_client->notifyOfHoldToTalkStart(m_holdAudioProvider);
+        m_mode = Mode::HOLD_TO_TALK;
+        m_stats.starts++;
+        return true;
+    }
+
+    bool RecognizeController::StartWakeWord(alexaClientSDK::capabilityAgents::aip::AudioProvider wakeAudioProvider,
+        alexaClientSDK::avsCommon::avs::AudioInputStream::Index beginIndex,
+        alexaClientSDK::avsCommon::avs::AudioInputStream::Index endIndex,
+        const std::string& keyword,
+        std::chrono::steady_clock::time_point keywordTime)
+    {
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        if (m_mode != Mode::NONE) {
+            XLOGD_DEBUG("Recognize already started");
+            m_stats.ignored++;
+            return true;
+        }
+
+        PreemptDialog();
+        m_client->notifyOfWakeWord(wakeAudioProvider, beginIndex, endIndex, keyword, keywordTime);
+        m_mode = Mode::WAKE_WORD;
+        m_stats.starts++;
+        return true;
+    }
+
+    bool RecognizeController::Stop()
+    {
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        switch (m_mode) {
+        case Mode::HOLD_TO_TALK:
+            m_client->notifyOfHoldToTalkEnd();
+            break;
+        case Mode::WAKE_WORD:
+            m_client->notifyOfTapToTalkEnd();
+            break;
+        case Mode::NONE:
+            XLOGD_DEBUG("No recognize to stop");
+            m_stats.ignored++;
+            return true;
+        }
+        m_mode = Mode::NONE;
+        m_stats.stops++;
+        return true;
+    }
+
+    bool RecognizeController::Cancel()
+    {
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        if (m_mode == Mode::NONE && m_dialogState != DialogUXState::LISTENING && m_dialogState != DialogUXState::THINKING) {
+            m_stats.ignored++;
+            return true;
+        }
+
+        // Releasing the dialog channel resets the AudioInputProcessor and drops the pending response
+        m_client->stopForegroundActivity();
+        m_mode = Mode::NONE;
+        m_stats.cancels++;
+        return true;
+    }
+
+    RecognizeController::Stats RecognizeController::GetStats()
+    {
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        Stats stats = m_stats;
+        AccountStateTime(std::chrono::steady_clock::now(), stats);
+        return stats;
+    }
+
+    void RecognizeController::onDialogUXStateChanged(DialogUXState newState)
+    {
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        if (newState == m_dialogState) {
+            return;
+        }
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        AccountStateTime(now, m_stats);
+        XLOGD_DEBUG("Dialog state <%s> -> <%s>", DialogUXStateObserverInterface::stateToString(m_dialogState).c_str(),
+            DialogUXStateObserverInterface::stateToString(newState).c_str());
+
+        // The cloud closed the capture (StopCapture or timeout), a later stop has nothing left to end
+        if (m_dialogState == DialogUXState::LISTENING && newState != DialogUXState::EXPECTING) {
+            m_mode = Mode::NONE;
+        }
+        if (m_dialogState == DialogUXState::LISTENING && m_captureClosedHandler) {
+            m_captureClosedHandler(now);
+        }
+
+        m_dialogState = newState;
+        m_dialogStateSince = now;
+    }
+
+    void RecognizeController::SetCaptureClosedHandler(CaptureClosedHandler handler)
+    {
+        const std::lock_guard<std::mutex> lock{ m_mutex };
+        m_captureClosedHandler = handler;
+    }
+
+    void RecognizeController::PreemptDialog()
+    {
+        if (m_dialogState == DialogUXState::THINKING || m_dialogState == DialogUXState::SPEAKING) {
+            XLOGD_INFO("Pre-empting dialog in <%s>", DialogUXStateObserverInterface::stateToString(m_dialogState).c_str());
+            m_client->stopForegroundActivity();
+            m_stats.preemptions++;
+        }
+    }
+
+    void RecognizeController::AccountStateTime(const std::chrono::steady_clock::time_point now, Stats& stats) const
+    {
+        const uint64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_dialogStateSince).count();
+        switch (m_dialogState) {
+        case DialogUXState::IDLE:      stats.idleMs      += elapsedMs; break;
+        case DialogUXState::LISTENING: stats.listeningMs += elapsedMs; break;
+        case DialogUXState::EXPECTING: stats.expectingMs += elapsedMs; break;
+        case DialogUXState::THINKING:  stats.thinkingMs  += elapsedMs; break;
+        case DialogUXState::SPEAKING:  stats.speakingMs  += elapsedMs; break;
+        case DialogUXState::FINISHED:  break;
+        }
+    }
+
+} // namespace WPEFramework
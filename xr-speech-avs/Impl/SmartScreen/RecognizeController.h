@@ -0,0 +1,103 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <rdkx_logger.h>
+
+#include <AVSCommon/SDKInterfaces/DialogUXStateObserverInterface.h>
+#include <SmartScreen/SampleApp/SampleApplication.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+
+namespace WPEFramework {
+
+    /// Drives the AudioInputProcessor with explicit start, stop and cancel operations instead of toggling hold to
+    /// talk. Every operation is idempotent, a duplicated or dropped stop can not invert the recognize state. The
+    /// dialog state is tracked through DialogUXState callbacks so a start during THINKING or SPEAKING pre-empts the
+    /// ongoing dialog first.
+    class RecognizeController : public alexaClientSDK::avsCommon::sdkInterfaces::DialogUXStateObserverInterface {
+    public:
+        enum class Mode {
+            NONE,
+            HOLD_TO_TALK,
+            WAKE_WORD
+        };
+
+        struct Stats {
+            uint32_t starts;          ///< Recognizes opened
+            uint32_t stops;           ///< Recognizes closed by the end of the stream
+            uint32_t cancels;         ///< Recognizes cancelled
+            uint32_t preemptions;     ///< Starts that interrupted a THINKING or SPEAKING dialog
+            uint32_t ignored;         ///< Duplicated starts and stops without an open recognize
+            uint64_t idleMs;          ///< Time spent in each dialog state
+            uint64_t listeningMs;
+            uint64_t expectingMs;
+            uint64_t thinkingMs;
+            uint64_t speakingMs;
+        };
+
+        /// Called when the AudioInputProcessor stops capturing, the recognize audio has been handed to the upload
+        typedef std::function<void(std::chrono::steady_clock::time_point)> CaptureClosedHandler;
+
+        static std::unique_ptr<RecognizeController> create(std::shared_ptr<alexaSmartScreenSDK::smartScreenClient::SmartScreenClient> client,
+            alexaClientSDK::capabilityAgents::aip::AudioProvider holdAudioProvider);
+
+        RecognizeController(const RecognizeController&) = delete;
+        RecognizeController& operator=(const RecognizeController&) = delete;
+        ~RecognizeController() = default;
+
+        bool Start();
+        bool StartWakeWord(alexaClientSDK::capabilityAgents::aip::AudioProvider wakeAudioProvider,
+            alexaClientSDK::avsCommon::avs::AudioInputStream::Index beginIndex,
+            alexaClientSDK::avsCommon::avs::AudioInputStream::Index endIndex,
+            const std::string& keyword,
+            std::chrono::steady_clock::time_point keywordTime);
+        bool Stop();
+        bool Cancel();
+        Stats GetStats();
+        void SetCaptureClosedHandler(CaptureClosedHandler handler);
+
+        void onDialogUXStateChanged(DialogUXState newState) override;
+
+    private:
+        RecognizeController(std::shared_ptr<alexaSmartScreenSDK::smartScreenClient::SmartScreenClient> client,
+            alexaClientSDK::capabilityAgents::aip::AudioProvider holdAudioProvider);
+
+        void PreemptDialog();
+        void AccountStateTime(const std::chrono::steady_clock::time_point now, Stats& stats) const;
+
+    private:
+        std::shared_ptr<alexaSmartScreenSDK::smartScreenClient::SmartScreenClient> m_client;
+        alexaClientSDK::capabilityAgents::aip::AudioProvider m_holdAudioProvider;
+        std::mutex m_mutex;
+        Mode m_mode;
+        DialogUXState m_dialogState;
+        std::chrono::steady_clock::time_point m_dialogStateSince;
+        Stats m_stats;
+        CaptureClosedHandler m_captureClosedHandler;
+    };
+
+} // namespace WPEFramework
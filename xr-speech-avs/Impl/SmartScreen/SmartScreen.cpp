@@ -29,6 +29,9 @@
 
 #include "ThunderLogger.h"
 #include "ThunderVoiceHandler.h"
+#include "AudioReferenceSink.h"
+#include "SessionTracer.h"
+#include "FlightRecorder.h"
 
 #include <acsdkAlerts/Storage/SQLiteAlertStorage.h>
 #include <acsdkBluetooth/BasicDeviceConnectionRule.h>
@@ -101,6 +104,100 @@ namespace WPEFramework {
     static const unsigned int NUM_CHANNELS = 1;
     static const std::chrono::seconds AMOUNT_OF_AUDIO_DATA_IN_BUFFER = std::chrono::seconds(15);
     static const size_t BUFFER_SIZE_IN_SAMPLES = (SAMPLE_RATE_HZ)*AMOUNT_OF_AUDIO_DATA_IN_BUFFER.count();
+    // One entry per 10 ms write covers everything the SDS holds
+    static const size_t CAPTURE_INDEX_ENTRIES = AMOUNT_OF_AUDIO_DATA_IN_BUFFER.count() * 100;
+    static const uint64_t NS_PER_SECOND = 1000000000ULL;
+
+    // Staging queue between the xrsr audio thread and the SDS writer thread
+    static const size_t STAGING_QUEUE_CAPACITY = 128;
+    static const uint32_t SDS_WRITER_WAIT_MS = 100;
+    static const std::chrono::milliseconds SDS_WRITER_FLUSH_TIMEOUT = std::chrono::milliseconds(500);
+    // A batch producer waits this long for the writer to free a slot before the rest of the batch is dropped
+    static const std::chrono::milliseconds STAGING_SPACE_TIMEOUT = std::chrono::milliseconds(500);
+    static const std::chrono::milliseconds STAGING_SPACE_POLL = std::chrono::milliseconds(2);
+    static const size_t END_OF_SPEECH_QUEUE_CAPACITY = 4;
+
+    // Audio ingest configuration
+    static const std::string AUDIO_INGEST_KEY("audioIngest");
+    static const std::string JITTER_BUFFER_KEY("jitterBuffer");
+    static const std::string ENABLED_KEY("enabled");
+    static const std::string FRAME_MS_KEY("frameMs");
+    static const std::string MIN_DELAY_MS_KEY("minDelayMs");
+    static const std::string MAX_DELAY_MS_KEY("maxDelayMs");
+    static const int DEFAULT_JITTER_FRAME_MS = 20;
+    static const int DEFAULT_JITTER_MIN_DELAY_MS = 40;
+    static const int DEFAULT_JITTER_MAX_DELAY_MS = 300;
+    static const std::string SEQUENCE_KEY("sequence");
+    static const std::string REORDER_WINDOW_FRAMES_KEY("reorderWindowFrames");
+    static const std::string MAX_CONCEAL_FRAMES_KEY("maxConcealFrames");
+    static const int DEFAULT_REORDER_WINDOW_FRAMES = 4;
+    static const int DEFAULT_MAX_CONCEAL_FRAMES = 10;
+    static const std::string OPUS_UPLOAD_KEY("opusUpload");
+    static const std::string COMPLEXITY_KEY("complexity");
+    // Opus parameters required by the AVS recognize event
+    static const uint32_t OPUS_UPLOAD_BIT_RATE = 32000;
+    static const uint32_t OPUS_UPLOAD_FRAME_MS = 20;
+    static const int DEFAULT_OPUS_UPLOAD_COMPLEXITY = 4;
+    static const std::string ENDPOINTER_KEY("endpointer");
+    static const std::string MODE_KEY("mode");
+    static const std::string MODE_LOCAL("local");
+    static const std::string MODE_REPORT("report");
+    static const std::string THRESHOLD_DB_KEY("thresholdDb");
+    static const std::string ZCR_PERCENT_KEY("zcrPercent");
+    static const std::string MIN_SPEECH_MS_KEY("minSpeechMs");
+    static const std::string HANGOVER_MS_KEY("hangoverMs");
+    static const uint32_t VAD_FRAME_MS = 10;
+    static const int DEFAULT_VAD_THRESHOLD_DB = 12;
+    static const int DEFAULT_VAD_ZCR_PERCENT = 30;
+    static const int DEFAULT_VAD_MIN_SPEECH_MS = 200;
+    static const int DEFAULT_VAD_HANGOVER_MS = 600;
+    static const std::string SILENCE_TRIM_KEY("silenceTrim");
+    static const std::string PAD_MS_KEY("padMs");
+    static const std::string ONSET_MS_KEY("onsetMs");
+    static const std::string MAX_TRIM_MS_KEY("maxTrimMs");
+    static const int DEFAULT_TRIM_PAD_MS = 150;
+    static const int DEFAULT_TRIM_ONSET_MS = 30;
+    static const int DEFAULT_TRIM_MAX_TRIM_MS = 1500;
+    static const int DEFAULT_TRIM_THRESHOLD_DB = 12;
+    static const std::string NOISE_SUPPRESSION_KEY("noiseSuppression");
+    static const std::string SUPPRESSION_DB_KEY("suppressionDb");
+    static const std::string BUDGET_US_KEY("budgetUs");
+    static const int DEFAULT_SUPPRESSION_DB = 12;
+    // A quarter of the 8 ms hop
+    static const int DEFAULT_SUPPRESSION_BUDGET_US = 2000;
+    static const std::string ECHO_CANCELLATION_KEY("echoCancellation");
+    static const std::string TAIL_MS_KEY("tailMs");
+    static const std::string AUDIO_SINK_KEY("audioSink");
+    static const std::string GSTREAMER_MEDIA_PLAYER_KEY("gstreamerMediaPlayer");
+    static const std::string DEFAULT_ECHO_AUDIO_SINK("autoaudiosink");
+    static const int DEFAULT_ECHO_TAIL_MS = 32;
+    static const int DEFAULT_ECHO_MAX_DELAY_MS = 500;
+    // Reference history beyond the delay and the tail, covers late arrival of the microphone audio
+    static const uint32_t ECHO_REFERENCE_MARGIN_MS = 500;
+    // Wake word recognize
+    static const std::string WAKE_WORD_KEYWORD("ALEXA");
+    // The AudioInputProcessor rewinds 500 ms ahead of the keyword, shorter pre-rolls are padded with silence
+    static const size_t WAKE_WORD_PREROLL_SAMPLES = SAMPLE_RATE_HZ / 2;
+    // 20 ms at 16 kHz / 16-bit mono, used for concealment until a real frame size is known
+    static const uint32_t DEFAULT_FRAME_BYTES = 640;
+
+    // Flight recorder configuration
+    static const std::string FLIGHT_RECORDER_KEY("flightRecorder");
+    static const std::string PATH_KEY("path");
+    static const std::string SIZE_KB_KEY("sizeKb");
+    static const std::string DEFAULT_FLIGHT_RECORDER_PATH("/tmp/avs-flight-recorder.bin");
+    static const int DEFAULT_FLIGHT_RECORDER_SIZE_KB = 256;
+
+    // VoiceToApps dispatch configuration
+    static const std::string VOICE_TO_APPS_DISPATCH_KEY("voiceToAppsDispatch");
+    static const std::string WORKERS_KEY("workers");
+    static const std::string CAPACITY_KEY("capacity");
+    static const std::string OVERFLOW_KEY("overflow");
+    static const std::string OVERFLOW_DROP_OLDEST("dropOldest");
+    static const std::string OVERFLOW_DROP_NEWEST("dropNewest");
+    static const int DEFAULT_DISPATCH_WORKERS = 1;
+    static const int MAX_DISPATCH_WORKERS = 1;
+    static const int DEFAULT_DISPATCH_CAPACITY = 32;
 
     // smart screein
     static const std::string WEBSOCKET_INTERFACE_KEY("websocketInterface");
@@ -199,12 +296,30 @@ namespace WPEFramework {
     auto& appConfig = *configEntry;
     auto config = appConfig[SAMPLE_APP_CONFIG_KEY];
 
+    // First so that everything going wrong from here on is recorded
+    if (!InitFlightRecorder(config[FLIGHT_RECORDER_KEY])) {
+        XLOGD_WARN("Running without the flight recorder");
+    }
+
     auto httpFactory = std::make_shared<avsCommon::utils::libcurlUtils::HTTPContentFetcherFactory>();
      std::shared_ptr<alexaClientSDK::storage::sqliteStorage::SQLiteMiscStorage> miscStorage =
          alexaClientSDK::storage::sqliteStorage::SQLiteMiscStorage::create(appConfig);
 
     bool equalizerEnabled = false;
 
+    // The reference sink is selected by name when the media players build their pipelines
+    if (!InitEchoCanceller(config[AUDIO_INGEST_KEY][ECHO_CANCELLATION_KEY])) {
+        XLOGD_ERROR("Failed to create the echo canceller");
+        return false;
+    }
+    if (m_echoCanceller) {
+        std::string playerSink;
+        appConfig[GSTREAMER_MEDIA_PLAYER_KEY].getString(AUDIO_SINK_KEY, &playerSink, DEFAULT_ECHO_AUDIO_SINK);
+        if (playerSink != AudioReferenceSink::ELEMENT_NAME) {
+            XLOGD_WARN("Media players use <%s>, echo cancellation has no reference", playerSink.c_str());
+        }
+    }
+
     auto speakerInterface = createApplicationMediaPlayer(httpFactory, false, "SpeakMediaPlayer");
     if (!speakerInterface) {
         XLOGD_ERROR("Failed to create application media interfaces for speech!");
@@ -457,11 +572,20 @@ namespace WPEFramework {
     appAudioFromat.endianness = alexaClientSDK::avsCommon::utils::AudioFormat::Endianness::LITTLE;
     appAudioFromat.encoding = alexaClientSDK::avsCommon::utils::AudioFormat::Encoding::LPCM;
     appAudioFromat.dataSigned = false;
-    
+
+    // The recognize event streams whatever the SDS holds, Opus frames when the upload encoder is enabled
+    if (!InitUploadEncoder(config[AUDIO_INGEST_KEY][OPUS_UPLOAD_KEY])) {
+        XLOGD_ERROR("Failed to create the upload encoder");
+        return false;
+    }
+    alexaClientSDK::avsCommon::utils::AudioFormat appUploadFormat = appAudioFromat;
+    if (m_audioEncoder) {
+        appUploadFormat.encoding = alexaClientSDK::avsCommon::utils::AudioFormat::Encoding::OPUS;
+    }
     
     alexaClientSDK::capabilityAgents::aip::AudioProvider appTapAudioProv(
         sharedDataStream,
-        appAudioFromat,
+        appUploadFormat,
         alexaClientSDK::capabilityAgents::aip::ASRProfile::NEAR_FIELD,
         true,
         true,
@@ -469,7 +593,7 @@ namespace WPEFramework {
     
     alexaClientSDK::capabilityAgents::aip::AudioProvider appHoldAudioProv(
         sharedDataStream,
-        appAudioFromat,
+        appUploadFormat,
         alexaClientSDK::capabilityAgents::aip::ASRProfile::CLOSE_TALK,
         false,
         true,
@@ -481,11 +605,6 @@ namespace WPEFramework {
         // Audio input
         std::shared_ptr<applicationUtilities::resources::audio::MicrophoneInterface> aspInput = nullptr;
 
-    aspInputInteractionHandler = InteractionHandler<alexaSmartScreenSDK::sampleApp::gui::GUIManager>::Create();
-        if (!aspInputInteractionHandler) {
-            XLOGD_ERROR("Failed to create aspInputInteractionHandler");
-            return false;
-        }
         m_thunderVoiceHandler = ThunderVoiceHandler<alexaSmartScreenSDK::sampleApp::gui::GUIManager>::create(sharedDataStream, appAudioFromat);
         aspInput = m_thunderVoiceHandler;
         aspInput->startStreamingMicrophoneData();
@@ -496,9 +615,51 @@ namespace WPEFramework {
             XLOGD_ERROR("Failed to create aspInput");
             return false;
         }
+
+        if (!InitSequenceTracker(config[AUDIO_INGEST_KEY][SEQUENCE_KEY])) {
+            XLOGD_ERROR("Failed to create the sequence tracker");
+            return false;
+        }
+
+        if (!InitJitterBuffer(config[AUDIO_INGEST_KEY][JITTER_BUFFER_KEY])) {
+            XLOGD_ERROR("Failed to create the jitter buffer");
+            return false;
+        }
+
+        if (!InitNoiseSuppressor(config[AUDIO_INGEST_KEY][NOISE_SUPPRESSION_KEY])) {
+            XLOGD_ERROR("Failed to create the noise suppressor");
+            return false;
+        }
+
+        if (!InitEndpointer(config[AUDIO_INGEST_KEY][ENDPOINTER_KEY])) {
+            XLOGD_ERROR("Failed to create the end-pointer");
+            return false;
+        }
+
+        if (!InitSilenceTrimmer(config[AUDIO_INGEST_KEY][SILENCE_TRIM_KEY])) {
+            XLOGD_ERROR("Failed to create the silence trimmer");
+            return false;
+        }
+
+        m_levelMeter = AudioLevelMeter::create();
+        m_captureIndex = AudioCaptureIndex::create(CAPTURE_INDEX_ENTRIES);
+        m_writeLatency = AudioLatencyHistogram::create();
+        m_uploadLatency = AudioLatencyHistogram::create();
+        m_writeLatencyStats = m_writeLatency->GetStats();
+
+        if (!StartSdsWriter()) {
+            XLOGD_ERROR("Failed to start the SDS writer");
+            return false;
+        }
        
-      alexaClientSDK::capabilityAgents::aip::AudioProvider
-      appWakeAudioProv(capabilityAgents::aip::AudioProvider::null());
+      // Reads back from the keyword begin index, so it must be able to seek into the pre-roll
+      m_wakeAudioProvider = alexaClientSDK::capabilityAgents::aip::AudioProvider(
+        sharedDataStream,
+        appAudioFromat,
+        alexaClientSDK::capabilityAgents::aip::ASRProfile::NEAR_FIELD,
+        true,
+        true,
+        true);
       
 	  
     m_guiManager = alexaSmartScreenSDK::sampleApp::gui::GUIManager::create(
@@ -511,14 +672,6 @@ namespace WPEFramework {
         aspInput,
         alexaClientSDK::capabilityAgents::aip::AudioProvider::null());
 
-        if (aspInputInteractionHandler) {
-            // register interactions
-            if (!aspInputInteractionHandler->Initialize(m_guiManager)) {
-                XLOGD_ERROR("Failed to initialize aspInputInteractionHandle");
-                return false;
-            }
-        }
-        
         
     
     std::shared_ptr<alexaSmartScreenSDK::smartScreenClient::SmartScreenClient> client = alexaSmartScreenSDK::smartScreenClient::SmartScreenClient::create(
@@ -592,6 +745,14 @@ namespace WPEFramework {
     client->addFocusManagersObserver(m_guiManager);
     client->addAudioInputProcessorObserver(m_guiManager);
     m_guiManager->setClient(client);
+
+    m_recognizeController = RecognizeController::create(client, appHoldAudioProv);
+    if (!m_recognizeController) {
+        XLOGD_ERROR("Failed to create m_recognizeController");
+        return false;
+    }
+    client->addAlexaDialogStateObserver(m_recognizeController);
+    m_recognizeController->SetCaptureClosedHandler(std::bind(&SmartScreen::OnCaptureClosed, this, std::placeholders::_1));
     m_guiClient->setGUIManager(m_guiManager);
     
     m_shutdownManager = client->getShutdownManager();
@@ -606,6 +767,10 @@ namespace WPEFramework {
         XLOGD_ERROR("Failed to create m_thunderInputManager");
       return false;
     }
+    if (!InitDispatchQueue(config[VOICE_TO_APPS_DISPATCH_KEY])) {
+        XLOGD_ERROR("Failed to start the VoiceToApps dispatch queue");
+        return false;
+    }
 
     delAuth->addAuthObserver(m_guiClient);
     client->getRegistrationManager()->addObserver(m_guiClient);
@@ -701,12 +866,24 @@ namespace WPEFramework {
 	    {
                 m_isStarted = true;
 
-                if (aspInputInteractionHandler) {
-                    aspInputInteractionHandler->HoldToTalk();
+                // A detected keyword is only usable while the SDS holds LPCM, the indices are sample offsets
+                {
+                    const std::lock_guard<std::mutex> lock{ m_inputFormatMutex };
+                    m_wakeWordSession = m_keywordSet && m_recognizeController && !m_audioEncoder;
+                    m_keywordSet = false;
+                }
+                m_sessionBegin = true;
+
+                if (m_wakeWordSession) {
+                    // The SDS writer opens the recognize once the keyword end has been written
+                    XLOGD_DEBUG("Wake word session, recognize follows the keyword");
+                }
+                else if (m_recognizeController) {
+                    m_recognizeController->Start();
                 }
 				else
 				{
-					XLOGD_ERROR("aspInputInteractionHandler is NULL!");
+					XLOGD_ERROR("m_recognizeController is NULL!");
 				}
 		}	
 	}
@@ -717,27 +894,1091 @@ namespace WPEFramework {
 			
 			if(m_isStarted == true) {
 
-            if (aspInputInteractionHandler) {
-                aspInputInteractionHandler->HoldToTalk();
+            // Make sure the tail of the utterance reaches the SDS before the recognize is closed
+            FlushSdsWriter();
+            UpdateEndpointStats();
+
+            if (m_recognizeController) {
+                m_recognizeController->Stop();
             }
 			else
 			{
-				XLOGD_ERROR("aspInputInteractionHandler is NULL!");
+				XLOGD_ERROR("m_recognizeController is NULL!");
 			}
 			
              m_isStarted = false;
           }
         }
 
-    void SmartScreen::Data(const uint32_t sequenceNo, const uint8_t data[], const uint16_t length)
+    void SmartScreen::Cancel()
+    {
+        XLOGD_DEBUG("AVS cancel voice...");
+
+        if (m_isStarted == true) {
+            FlushSdsWriter();
+            m_isStarted = false;
+        }
+        if (m_recognizeController) {
+            m_recognizeController->Cancel();
+        }
+    }
+
+    bool SmartScreen::GetRecognizeStats(RecognizeController::Stats& stats)
+    {
+        if (!m_recognizeController) {
+            return false;
+        }
+        stats = m_recognizeController->GetStats();
+        return true;
+    }
+
+    // Runs on the xrsr audio thread; frames are only staged here so xrsr never waits on SDS internals. A single frame
+    // that does not fit is dropped straight away, a batch larger than the free space (pre-roll, file replay) is
+    // queued in parts as the writer thread drains the ring.
+    uint32_t SmartScreen::Data(const uint32_t sequenceNo, const struct iovec frames[], const uint32_t count)
+    {
+        // An empty frame would take a sequence number without a staging slot and be concealed as lost downstream
+        for (uint32_t index = 0; index < count; index++) {
+            if (frames[index].iov_base == nullptr || frames[index].iov_len == 0) {
+                XLOGD_ERROR("Empty frame <%u> of <%u>, batch rejected", index, count);
+                return 0;
+            }
+        }
+
+        if (!m_stagingQueue) {
+            for (uint32_t index = 0; index < count; index++) {
+                WriteToStream(static_cast<const uint8_t*>(frames[index].iov_base), frames[index].iov_len);
+            }
+            return count;
+        }
+
+        uint32_t queued = 0;
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + STAGING_SPACE_TIMEOUT;
+        while (queued < count) {
+            const uint32_t first = (sequenceNo == 0 ? 0 : sequenceNo + queued);
+            const uint32_t accepted = static_cast<uint32_t>(m_stagingQueue->PushV(first, frames + queued, count - queued));
+            queued += accepted;
+            if (queued == count || count == 1) {
+                break;
+            }
+            if (accepted > 0) {
+                deadline = std::chrono::steady_clock::now() + STAGING_SPACE_TIMEOUT;
+            } else if (std::chrono::steady_clock::now() >= deadline || m_stagingQueue->GetStats().depth == 0) {
+                // The writer stopped draining, or the frame is larger than the whole ring
+                break;
+            }
+            std::this_thread::sleep_for(STAGING_SPACE_POLL);
+        }
+
+        if (queued < count) {
+            m_stagingQueue->Drop(count - queued);
+            FlightRecorder::instance()->Record(FlightRecorder::Type::STAGING_DROP, count - queued);
+        }
+        return queued;
+    }
+
+    bool SmartScreen::GetQueueStats(AudioStagingQueue::Stats& stats) const
+    {
+        if (!m_stagingQueue) {
+            return false;
+        }
+        stats = m_stagingQueue->GetStats();
+        return true;
+    }
+
+    bool SmartScreen::GetJitterStats(AudioJitterBuffer::Stats& stats)
+    {
+        if (!m_jitterBuffer) {
+            return false;
+        }
+        const std::lock_guard<std::mutex> lock{ m_ingestStatsMutex };
+        stats = m_jitterStats;
+        return true;
+    }
+
+    bool SmartScreen::GetSequenceStats(AudioSequenceTracker::Stats& stats)
+    {
+        if (!m_sequenceTracker) {
+            return false;
+        }
+        const std::lock_guard<std::mutex> lock{ m_ingestStatsMutex };
+        stats = m_sequenceStats;
+        return true;
+    }
+
+    bool SmartScreen::GetEncoderStats(AudioEncoder::Stats& stats)
+    {
+        if (!m_audioEncoder) {
+            return false;
+        }
+        const std::lock_guard<std::mutex> lock{ m_ingestStatsMutex };
+        stats = m_encoderStats;
+        return true;
+    }
+
+    bool SmartScreen::InitUploadEncoder(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config)
+    {
+        bool enabled = false;
+        config.getBool(ENABLED_KEY, &enabled, false);
+        if (!enabled) {
+            return true;
+        }
+
+        int complexity;
+        config.getInt(COMPLEXITY_KEY, &complexity, DEFAULT_OPUS_UPLOAD_COMPLEXITY);
+        if (complexity < 0 || complexity > 10) {
+            XLOGD_ERROR("Invalid opus complexity <%d>", complexity);
+            return false;
+        }
+
+        AudioEncoder::Config encoderConfig;
+        encoderConfig.sampleRateHz = SAMPLE_RATE_HZ;
+        encoderConfig.bitRate = OPUS_UPLOAD_BIT_RATE;
+        encoderConfig.frameMs = OPUS_UPLOAD_FRAME_MS;
+        encoderConfig.complexity = complexity;
+        m_audioEncoder = AudioEncoder::create(encoderConfig);
+        if (!m_audioEncoder) {
+            // Not fatal, the upload stays LPCM
+            XLOGD_WARN("Opus upload requested but unavailable, uploading LPCM");
+            return true;
+        }
+        m_encoderStats = m_audioEncoder->GetStats();
+
+        XLOGD_INFO("Opus upload enabled complexity <%d>", complexity);
+        return true;
+    }
+
+    bool SmartScreen::GetTrimStats(AudioSilenceTrimmer::Stats& stats)
+    {
+        if (!m_silenceTrimmer) {
+            return false;
+        }
+        const std::lock_guard<std::mutex> lock{ m_ingestStatsMutex };
+        stats = m_trimStats;
+        return true;
+    }
+
+    bool SmartScreen::GetNoiseSuppressorStats(AudioNoiseSuppressor::Stats& stats)
+    {
+        if (!m_noiseSuppressor) {
+            return false;
+        }
+        const std::lock_guard<std::mutex> lock{ m_ingestStatsMutex };
+        stats = m_noiseSuppressorStats;
+        return true;
+    }
+
+    bool SmartScreen::GetLevelStats(AudioLevelMeter::Stats& stats) const
+    {
+        if (!m_levelMeter) {
+            return false;
+        }
+        stats = m_levelMeter->GetStats();
+        return true;
+    }
+
+    void SmartScreen::SetStreamBeginTime(const uint64_t timeNs)
+    {
+        m_streamBeginNs = timeNs;
+    }
+
+    bool SmartScreen::GetLatencyStats(LatencyStats& stats)
+    {
+        if (!m_uploadLatency) {
+            return false;
+        }
+        const std::lock_guard<std::mutex> lock{ m_ingestStatsMutex };
+        stats.captureToWrite = m_writeLatencyStats;
+        stats.captureToUpload = m_uploadLatency->GetStats();
+        stats.lastUploadUs = m_lastUploadUs;
+        return true;
+    }
+
+    void SmartScreen::BeginCaptureTimeline()
+    {
+        uint64_t keywordEnd;
+        {
+            const std::lock_guard<std::mutex> lock{ m_inputFormatMutex };
+            keywordEnd = m_keywordEnd;
+        }
+        const uint64_t inputRateHz = m_formatConverter ? m_formatConverter->InputRateHz() : SAMPLE_RATE_HZ;
+
+        // The stream begins at the keyword end, the buffered audio ahead of it was captured earlier. Without a
+        // stream begin time the first arrival anchors the timeline.
+        const uint64_t streamBeginNs = m_streamBeginNs.exchange(0);
+        const uint64_t bufferedNs = keywordEnd * NS_PER_SECOND / inputRateHz;
+        m_captureBaseNs = streamBeginNs > bufferedNs ? streamBeginNs - bufferedNs : 0;
+        m_captureSamples = 0;
+        m_uploadSamples = 0;
+        m_commitCaptureNs = 0;
+    }
+
+    void SmartScreen::AdvanceCaptureTimeline(const size_t samples, const uint64_t arrivalNs)
+    {
+        const uint64_t durationNs = samples * NS_PER_SECOND / SAMPLE_RATE_HZ;
+        if (m_captureBaseNs == 0) {
+            m_captureBaseNs = arrivalNs > durationNs ? arrivalNs - durationNs : 1;
+        }
+        m_captureSamples += samples;
+
+        // Audio can not have been captured after it arrived, the stream began earlier than reported
+        const uint64_t captureNs = CaptureTimeNs(m_captureSamples);
+        if (captureNs > arrivalNs) {
+            m_captureBaseNs -= std::min(captureNs - arrivalNs, m_captureBaseNs - 1);
+        }
+    }
+
+    uint64_t SmartScreen::CaptureTimeNs(const uint64_t sample) const
+    {
+        if (m_captureBaseNs == 0) {
+            return 0;
+        }
+        return m_captureBaseNs + sample * NS_PER_SECOND / SAMPLE_RATE_HZ;
+    }
+
+    void SmartScreen::OnCaptureClosed(const std::chrono::steady_clock::time_point closedTime)
+    {
+        if (!v_writer || !m_captureIndex) {
+            return;
+        }
+
+        // The last word written before the capture closed is the last one the recognize uploads
+        const uint64_t wordIndex = v_writer->tell();
+        AudioCaptureIndex::Entry entry;
+        if (wordIndex == 0 || !m_captureIndex->Lookup(wordIndex - 1, entry)) {
+            return;
+        }
+        const uint64_t closedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(closedTime.time_since_epoch()).count();
+        if (closedNs <= entry.captureNs) {
+            return;
+        }
+
+        const std::lock_guard<std::mutex> lock{ m_ingestStatsMutex };
+        m_uploadLatency->Record(closedNs - entry.captureNs);
+        m_lastUploadUs = static_cast<uint32_t>((closedNs - entry.captureNs) / 1000);
+        XLOGD_INFO("Capture to upload <%u us> written after <%llu us>", m_lastUploadUs,
+            (unsigned long long)((entry.writtenNs - entry.captureNs) / 1000));
+    }
+
+    bool SmartScreen::GetEchoCancellerStats(AudioEchoCanceller::Stats& stats)
+    {
+        if (!m_echoCanceller) {
+            return false;
+        }
+        const std::lock_guard<std::mutex> lock{ m_ingestStatsMutex };
+        stats = m_echoCancellerStats;
+        return true;
+    }
+
+    bool SmartScreen::InitDispatchQueue(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config)
+    {
+        int workers, capacity;
+        std::string overflow;
+        config.getInt(WORKERS_KEY, &workers, DEFAULT_DISPATCH_WORKERS);
+        config.getInt(CAPACITY_KEY, &capacity, DEFAULT_DISPATCH_CAPACITY);
+        config.getString(OVERFLOW_KEY, &overflow, OVERFLOW_DROP_OLDEST);
+        if (workers == 0) {
+            XLOGD_INFO("VoiceToApps dispatch is synchronous");
+            return true;
+        }
+        if (workers < 0 || capacity <= 0 || (overflow != OVERFLOW_DROP_OLDEST && overflow != OVERFLOW_DROP_NEWEST)) {
+            XLOGD_ERROR("Invalid VoiceToApps dispatch configuration");
+            return false;
+        }
+        // Every task calls the one shared voiceToApps instance, which is not known to be thread safe
+        if (workers > MAX_DISPATCH_WORKERS) {
+            XLOGD_WARN("VoiceToApps dispatch workers <%d> capped at <%d>", workers, MAX_DISPATCH_WORKERS);
+            workers = MAX_DISPATCH_WORKERS;
+        }
+
+        DispatchQueue::Config dispatchConfig;
+        dispatchConfig.workers = workers;
+        dispatchConfig.capacity = capacity;
+        dispatchConfig.overflow = overflow == OVERFLOW_DROP_OLDEST ? DispatchQueue::OverflowPolicy::DROP_OLDEST : DispatchQueue::OverflowPolicy::DROP_NEWEST;
+        if (!m_thunderInputManager->StartDispatch(dispatchConfig)) {
+            return false;
+        }
+
+        XLOGD_INFO("VoiceToApps dispatch workers <%d> capacity <%d> overflow <%s>", workers, capacity, overflow.c_str());
+        return true;
+    }
+
+    bool SmartScreen::GetDispatchStats(DispatchQueue::Stats& stats) const
+    {
+        if (!m_thunderInputManager) {
+            return false;
+        }
+        return m_thunderInputManager->GetDispatchStats(stats);
+    }
+
+    bool SmartScreen::InitFlightRecorder(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config)
+    {
+        bool enabled = false;
+        config.getBool(ENABLED_KEY, &enabled, false);
+        if (!enabled) {
+            return true;
+        }
+
+        std::string path;
+        int sizeKb;
+        config.getString(PATH_KEY, &path, DEFAULT_FLIGHT_RECORDER_PATH);
+        config.getInt(SIZE_KB_KEY, &sizeKb, DEFAULT_FLIGHT_RECORDER_SIZE_KB);
+        if (path.empty() || sizeKb < 8 || sizeKb > 65536) {
+            XLOGD_ERROR("Invalid flight recorder configuration");
+            return false;
+        }
+
+        if (!FlightRecorder::instance()->Open(path, static_cast<size_t>(sizeKb) * 1024)) {
+            return false;
+        }
+
+        XLOGD_INFO("Flight recorder enabled path <%s> size <%d KB>", path.c_str(), sizeKb);
+        return true;
+    }
+
+    bool SmartScreen::InitEchoCanceller(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config)
+    {
+        bool enabled = false;
+        config.getBool(ENABLED_KEY, &enabled, false);
+        if (!enabled) {
+            return true;
+        }
+
+        int tailMs, maxDelayMs;
+        std::string audioSink;
+        config.getInt(TAIL_MS_KEY, &tailMs, DEFAULT_ECHO_TAIL_MS);
+        config.getInt(MAX_DELAY_MS_KEY, &maxDelayMs, DEFAULT_ECHO_MAX_DELAY_MS);
+        config.getString(AUDIO_SINK_KEY, &audioSink, DEFAULT_ECHO_AUDIO_SINK);
+        if (tailMs <= 0 || tailMs > 256 || maxDelayMs < 0 || maxDelayMs > 2000) {
+            XLOGD_ERROR("Invalid echo canceller configuration");
+            return false;
+        }
+
+        m_audioReference = AudioReference::create(SAMPLE_RATE_HZ, maxDelayMs + tailMs + ECHO_REFERENCE_MARGIN_MS);
+        if (!m_audioReference || !AudioReferenceSink::Register(m_audioReference, audioSink)) {
+            return false;
+        }
+
+        AudioEchoCanceller::Config cancellerConfig;
+        cancellerConfig.sampleRateHz = SAMPLE_RATE_HZ;
+        cancellerConfig.tailMs = tailMs;
+        cancellerConfig.maxDelayMs = maxDelayMs;
+        m_echoCanceller = AudioEchoCanceller::create(cancellerConfig, m_audioReference);
+        if (!m_echoCanceller) {
+            return false;
+        }
+        m_echoCancellerStats = m_echoCanceller->GetStats();
+
+        XLOGD_INFO("Echo cancellation enabled tail <%d ms> max delay <%d ms> audio sink <%s>", tailMs, maxDelayMs, audioSink.c_str());
+        return true;
+    }
+
+    bool SmartScreen::InitNoiseSuppressor(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config)
+    {
+        bool enabled = false;
+        config.getBool(ENABLED_KEY, &enabled, false);
+        if (!enabled) {
+            return true;
+        }
+
+        int suppressionDb, budgetUs;
+        config.getInt(SUPPRESSION_DB_KEY, &suppressionDb, DEFAULT_SUPPRESSION_DB);
+        config.getInt(BUDGET_US_KEY, &budgetUs, DEFAULT_SUPPRESSION_BUDGET_US);
+        if (suppressionDb <= 0 || suppressionDb > 40 || budgetUs < 0) {
+            XLOGD_ERROR("Invalid noise suppressor configuration");
+            return false;
+        }
+
+        AudioNoiseSuppressor::Config suppressorConfig;
+        suppressorConfig.sampleRateHz = SAMPLE_RATE_HZ;
+        suppressorConfig.suppressionDb = suppressionDb;
+        suppressorConfig.budgetUs = budgetUs;
+        m_noiseSuppressor = AudioNoiseSuppressor::create(suppressorConfig);
+        if (!m_noiseSuppressor) {
+            return false;
+        }
+        m_noiseSuppressorStats = m_noiseSuppressor->GetStats();
+
+        XLOGD_INFO("Noise suppression enabled level <%d dB> budget <%d us>", suppressionDb, budgetUs);
+        return true;
+    }
+
+    bool SmartScreen::InitSilenceTrimmer(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config)
+    {
+        bool enabled = false;
+        config.getBool(ENABLED_KEY, &enabled, false);
+        if (!enabled) {
+            return true;
+        }
+
+        int padMs, onsetMs, maxTrimMs, thresholdDb;
+        config.getInt(PAD_MS_KEY, &padMs, DEFAULT_TRIM_PAD_MS);
+        config.getInt(ONSET_MS_KEY, &onsetMs, DEFAULT_TRIM_ONSET_MS);
+        config.getInt(MAX_TRIM_MS_KEY, &maxTrimMs, DEFAULT_TRIM_MAX_TRIM_MS);
+        config.getInt(THRESHOLD_DB_KEY, &thresholdDb, DEFAULT_TRIM_THRESHOLD_DB);
+        if (padMs < 0 || onsetMs <= 0 || maxTrimMs <= 0 || thresholdDb <= 0) {
+            XLOGD_ERROR("Invalid silence trimmer configuration");
+            return false;
+        }
+
+        AudioSilenceTrimmer::Config trimConfig;
+        trimConfig.sampleRateHz = SAMPLE_RATE_HZ;
+        trimConfig.padMs = padMs;
+        trimConfig.onsetMs = onsetMs;
+        trimConfig.maxTrimMs = maxTrimMs;
+        trimConfig.thresholdDb = thresholdDb;
+        m_silenceTrimmer = AudioSilenceTrimmer::create(trimConfig);
+        if (!m_silenceTrimmer) {
+            return false;
+        }
+        m_trimStats = m_silenceTrimmer->GetStats();
+
+        XLOGD_INFO("Silence trimming enabled pad <%d ms> max <%d ms>", padMs, maxTrimMs);
+        return true;
+    }
+
+    bool SmartScreen::InitEndpointer(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config)
+    {
+        bool enabled = false;
+        config.getBool(ENABLED_KEY, &enabled, false);
+        if (!enabled) {
+            return true;
+        }
+
+        std::string mode;
+        int thresholdDb, zcrPercent, minSpeechMs, hangoverMs;
+        config.getString(MODE_KEY, &mode, MODE_REPORT);
+        config.getInt(THRESHOLD_DB_KEY, &thresholdDb, DEFAULT_VAD_THRESHOLD_DB);
+        config.getInt(ZCR_PERCENT_KEY, &zcrPercent, DEFAULT_VAD_ZCR_PERCENT);
+        config.getInt(MIN_SPEECH_MS_KEY, &minSpeechMs, DEFAULT_VAD_MIN_SPEECH_MS);
+        config.getInt(HANGOVER_MS_KEY, &hangoverMs, DEFAULT_VAD_HANGOVER_MS);
+        if ((mode != MODE_LOCAL && mode != MODE_REPORT) || thresholdDb <= 0 || zcrPercent <= 0 || minSpeechMs < 0 || hangoverMs <= 0) {
+            XLOGD_ERROR("Invalid end-pointer configuration");
+            return false;
+        }
+
+        AudioVad::Config vadConfig;
+        vadConfig.sampleRateHz = SAMPLE_RATE_HZ;
+        vadConfig.frameMs = VAD_FRAME_MS;
+        vadConfig.thresholdDb = thresholdDb;
+        vadConfig.zcrPercent = zcrPercent;
+        vadConfig.minSpeechMs = minSpeechMs;
+        vadConfig.hangoverMs = hangoverMs;
+        m_vad = AudioVad::create(vadConfig);
+        if (!m_vad) {
+            return false;
+        }
+        m_endpointLocal = (mode == MODE_LOCAL);
+
+        // The end of speech handler usually stops the stream, which flushes the SDS writer, so it cannot run on it
+        DispatchQueue::Config queueConfig;
+        queueConfig.capacity = END_OF_SPEECH_QUEUE_CAPACITY;
+        queueConfig.workers = 1;
+        queueConfig.overflow = DispatchQueue::OverflowPolicy::DROP_NEWEST;
+        m_endOfSpeechQueue = DispatchQueue::create(queueConfig);
+        if (!m_endOfSpeechQueue) {
+            return false;
+        }
+
+        XLOGD_INFO("End-pointer enabled mode <%s> threshold <%d dB> hangover <%d ms>", mode.c_str(), thresholdDb, hangoverMs);
+        return true;
+    }
+
+    void SmartScreen::SetEndOfSpeechHandler(EndOfSpeechHandler handler, void* userData)
+    {
+        const std::lock_guard<std::mutex> lock{ m_endOfSpeechMutex };
+        m_endOfSpeechHandler = handler;
+        m_endOfSpeechUserData = userData;
+    }
+
+    bool SmartScreen::GetEndpointStats(EndpointStats& stats)
+    {
+        if (!m_vad) {
+            return false;
+        }
+        const std::lock_guard<std::mutex> lock{ m_ingestStatsMutex };
+        stats = m_endpointStats;
+        return true;
+    }
+
+    // Runs on the SDS writer thread
+    void SmartScreen::OnEndOfSpeech()
+    {
+        m_endOfSpeechNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        XLOGD_INFO("Local end of speech at <%u ms>", m_vad->GetStats().endOfSpeechMs);
+
+        if (m_endpointLocal && m_recognizeController) {
+            m_recognizeController->Stop();
+        }
+
+        EndOfSpeechHandler handler;
+        void* userData;
+        {
+            const std::lock_guard<std::mutex> lock{ m_endOfSpeechMutex };
+            handler = m_endOfSpeechHandler;
+            userData = m_endOfSpeechUserData;
+        }
+        if (handler) {
+            m_endOfSpeechQueue->Post(DispatchQueue::Priority::HIGH, "endOfSpeech", [handler, userData]() { handler(userData); });
+        }
+    }
+
+    // Called once the stream has ended and the SDS writer is flushed
+    void SmartScreen::UpdateEndpointStats()
+    {
+        if (!m_vad) {
+            return;
+        }
+
+        const AudioVad::Stats vadStats = m_vad->GetStats();
+        const uint64_t endOfSpeechNs = m_endOfSpeechNs;
+        const uint64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        const std::lock_guard<std::mutex> lock{ m_ingestStatsMutex };
+        m_endpointStats.speechMs = vadStats.speechMs;
+        m_endpointStats.endOfSpeechMs = vadStats.endOfSpeechMs;
+        m_endpointStats.endOfSpeech = vadStats.endOfSpeech;
+        m_endpointStats.savedMs = (endOfSpeechNs != 0 && nowNs > endOfSpeechNs) ? static_cast<uint32_t>((nowNs - endOfSpeechNs) / 1000000) : 0;
+        if (vadStats.endOfSpeech) {
+            m_endpointStats.endpoints++;
+            m_endpointStats.savedMsTotal += m_endpointStats.savedMs;
+        }
+        XLOGD_INFO("End-pointer speech <%u ms> end of speech <%u ms> saved <%u ms>", m_endpointStats.speechMs, m_endpointStats.endOfSpeechMs, m_endpointStats.savedMs);
+    }
+
+    bool SmartScreen::InitSequenceTracker(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config)
+    {
+        int windowFrames, maxConcealFrames;
+        config.getInt(REORDER_WINDOW_FRAMES_KEY, &windowFrames, DEFAULT_REORDER_WINDOW_FRAMES);
+        config.getInt(MAX_CONCEAL_FRAMES_KEY, &maxConcealFrames, DEFAULT_MAX_CONCEAL_FRAMES);
+        if (windowFrames <= 0 || maxConcealFrames < 0) {
+            XLOGD_ERROR("Invalid sequence tracker configuration");
+            return false;
+        }
+
+        AudioSequenceTracker::Config sequenceConfig;
+        sequenceConfig.windowFrames = windowFrames;
+        sequenceConfig.maxConcealFrames = maxConcealFrames;
+        sequenceConfig.defaultFrameBytes = DEFAULT_FRAME_BYTES;
+        m_sequenceTracker = AudioSequenceTracker::create(sequenceConfig);
+        if (!m_sequenceTracker) {
+            return false;
+        }
+        m_sequenceStats = m_sequenceTracker->GetStats();
+        return true;
+    }
+
+    bool SmartScreen::InitJitterBuffer(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config)
+    {
+        bool enabled = false;
+        config.getBool(ENABLED_KEY, &enabled, false);
+        if (!enabled) {
+            XLOGD_INFO("Jitter buffer disabled");
+            return true;
+        }
+
+        int frameMs, minDelayMs, maxDelayMs;
+        config.getInt(FRAME_MS_KEY, &frameMs, DEFAULT_JITTER_FRAME_MS);
+        config.getInt(MIN_DELAY_MS_KEY, &minDelayMs, DEFAULT_JITTER_MIN_DELAY_MS);
+        config.getInt(MAX_DELAY_MS_KEY, &maxDelayMs, DEFAULT_JITTER_MAX_DELAY_MS);
+        if (frameMs <= 0 || minDelayMs < 0 || maxDelayMs <= 0) {
+            XLOGD_ERROR("Invalid jitter buffer configuration");
+            return false;
+        }
+
+        AudioJitterBuffer::Config jitterConfig;
+        jitterConfig.bytesPerSecond = SAMPLE_RATE_HZ * NUM_CHANNELS * WORD_SIZE;
+        jitterConfig.frameMs = frameMs;
+        jitterConfig.minDelayMs = minDelayMs;
+        jitterConfig.maxDelayMs = maxDelayMs;
+        m_jitterBuffer = AudioJitterBuffer::create(jitterConfig);
+        if (!m_jitterBuffer) {
+            return false;
+        }
+        m_jitterOut.resize(static_cast<size_t>(jitterConfig.bytesPerSecond) * maxDelayMs / 1000 * 4);
+        m_jitterStats = m_jitterBuffer->GetStats();
+
+        XLOGD_INFO("Jitter buffer enabled frame <%d ms> delay <%d-%d ms>", frameMs, minDelayMs, maxDelayMs);
+        return true;
+    }
+
+    bool SmartScreen::StartSdsWriter()
+    {
+        if (m_sdsWriterRunning) {
+            return true;
+        }
+
+        m_stagingQueue = AudioStagingQueue::create(STAGING_QUEUE_CAPACITY);
+        if (!m_stagingQueue) {
+            return false;
+        }
+
+        m_sdsWriterRunning = true;
+        m_sdsWriterThread = std::thread(&SmartScreen::SdsWriterWorker, this);
+        return true;
+    }
+
+    void SmartScreen::StopSdsWriter()
+    {
+        if (!m_sdsWriterRunning) {
+            return;
+        }
+
+        m_sdsWriterRunning = false;
+        m_stagingQueue->Signal();
+        if (m_sdsWriterThread.joinable()) {
+            m_sdsWriterThread.join();
+        }
+    }
+
+    void SmartScreen::FlushSdsWriter()
+    {
+        if (!m_sdsWriterRunning) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock{ m_flushMutex };
+        m_flushRequested = true;
+        m_stagingQueue->Signal();
+        if (!m_flushDone.wait_for(lock, SDS_WRITER_FLUSH_TIMEOUT, [this]() { return !m_flushRequested; })) {
+            XLOGD_WARN("Timed out flushing the SDS writer");
+        }
+    }
+
+    void SmartScreen::SdsWriterWorker()
+    {
+        XLOGD_DEBUG("Starting SDS writer thread..");
+
+        // With the jitter buffer the writer wakes up at least twice per frame to keep the cadence
+        const uint32_t waitMs = m_jitterBuffer ? std::max<uint32_t>(m_jitterBuffer->FrameMs() / 2, 1) : SDS_WRITER_WAIT_MS;
+
+        while (m_sdsWriterRunning) {
+            m_stagingQueue->Wait(waitMs);
+
+            // Sampled before draining so every frame staged ahead of the flush request is included
+            const bool flush = m_flushRequested;
+
+            if (m_sessionBegin.exchange(false)) {
+                m_sequenceTracker->ResetStats();
+                if (m_audioEncoder) {
+                    m_audioEncoder->ResetStats();
+                }
+                ApplyInputFormat();
+                // Ahead of the wake word pre-roll so it does not inherit the previous session's capture time
+                BeginCaptureTimeline();
+                m_sessionWritten = false;
+                BeginWakeWord();
+                if (m_vad) {
+                    m_vad->Reset();
+                }
+                if (m_echoCanceller) {
+                    m_echoCanceller->Reset();
+                }
+                if (m_levelMeter) {
+                    m_levelMeter->Reset();
+                }
+                // Wake word indices are offsets into the untrimmed stream
+                if (m_silenceTrimmer) {
+                    m_silenceTrimmer->Reset(!m_wakeWordSession);
+                }
+                m_endOfSpeechNs = 0;
+            }
+
+            const AudioStagingQueue::Frame* frame;
+            while ((frame = m_stagingQueue->Front()) != nullptr) {
+                ProcessFrame(*frame);
+                m_stagingQueue->Pop();
+            }
+
+            const uint64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            if (flush) {
+                m_sequenceOut.clear();
+                m_sequenceTracker->Flush(m_sequenceOut);
+                ForwardToStream(m_sequenceOut.data(), m_sequenceOut.size(), nowNs);
+                if (m_formatConverter) {
+                    m_formatConverter->Reset();
+                }
+                if (m_noiseSuppressor) {
+                    m_suppressOut.clear();
+                    m_noiseSuppressor->Flush(m_suppressOut);
+                    PlayoutToStream(m_suppressOut.data(), m_suppressOut.size(), nowNs);
+                }
+                if (m_audioDecoder) {
+                    const AudioDecoder::Stats decodeStats = m_audioDecoder->GetStats();
+                    XLOGD_INFO("Decoded frames <%llu> errors <%llu> samples <%llu> time <%llu us>",
+                        (unsigned long long)decodeStats.frames, (unsigned long long)decodeStats.errors,
+                        (unsigned long long)decodeStats.samples, (unsigned long long)decodeStats.decodeUs);
+                    m_audioDecoder->Reset();
+                }
+            }
+
+            if (m_jitterBuffer) {
+                size_t length;
+                while ((length = m_jitterBuffer->Pull(nowNs, m_jitterOut.data(), m_jitterOut.size(), flush)) > 0) {
+                    WriteToStream(m_jitterOut.data(), length);
+                }
+                if (flush) {
+                    m_jitterBuffer->Reset();
+                }
+            }
+
+            if (flush && m_silenceTrimmer) {
+                // An utterance too short to reach the onset is still uploaded
+                m_trimOut.clear();
+                m_silenceTrimmer->Flush(m_trimOut);
+                if (!m_trimOut.empty()) {
+                    EncodeToStream(m_trimOut.data(), m_trimOut.size());
+                }
+                XLOGD_INFO("Trimmed <%u ms> of leading silence", m_silenceTrimmer->GetStats().trimmedMs);
+            }
+
+            if (flush && m_audioEncoder) {
+                m_encodeOut.clear();
+                m_audioEncoder->Flush(m_encodeOut);
+                CommitToStream(m_encodeOut.data(), m_encodeOut.size());
+            }
+
+            DispatchWakeWord(flush);
+
+            {
+                const std::lock_guard<std::mutex> lock{ m_ingestStatsMutex };
+                m_sequenceStats = m_sequenceTracker->GetStats();
+                if (m_jitterBuffer) {
+                    m_jitterStats = m_jitterBuffer->GetStats();
+                }
+                if (m_audioEncoder) {
+                    m_encoderStats = m_audioEncoder->GetStats();
+                }
+                if (m_silenceTrimmer) {
+                    m_trimStats = m_silenceTrimmer->GetStats();
+                }
+                if (m_noiseSuppressor) {
+                    m_noiseSuppressorStats = m_noiseSuppressor->GetStats();
+                }
+                if (m_echoCanceller) {
+                    m_echoCancellerStats = m_echoCanceller->GetStats();
+                }
+                m_writeLatencyStats = m_writeLatency->GetStats();
+            }
+
+            // A snapshot a second while audio flows and the final one of each session
+            const AudioStagingQueue::Stats queueStats = m_stagingQueue->GetStats();
+            if (flush || (queueStats.enqueued != m_recordedEnqueued && nowNs >= m_recordedStatsNs + NS_PER_SECOND)) {
+                FlightRecorderFormat::IngestStats ingestStats;
+                ingestStats.framesEnqueued = queueStats.enqueued;
+                ingestStats.framesDropped = queueStats.dropped;
+                ingestStats.framesCommitted = queueStats.committed;
+                ingestStats.depth = queueStats.depth;
+                ingestStats.framesLost = static_cast<uint32_t>(m_sequenceStats.lost);
+                ingestStats.latencyUsMax = queueStats.latencyUsMax;
+                ingestStats.jitterMs = m_jitterBuffer ? m_jitterStats.jitterMs : 0;
+                FlightRecorder::instance()->Record(FlightRecorder::Type::INGEST_STATS, 0, &ingestStats, sizeof(ingestStats));
+                m_recordedEnqueued = queueStats.enqueued;
+                m_recordedStatsNs = nowNs;
+            }
+
+            if (flush) {
+                const std::lock_guard<std::mutex> lock{ m_flushMutex };
+                m_flushRequested = false;
+                m_flushDone.notify_all();
+            }
+        }
+    }
+
+    void SmartScreen::ProcessFrame(const AudioStagingQueue::Frame& frame)
+    {
+        if (m_inputUndecodable) {
+            return;
+        }
+
+        const uint8_t* data = frame.data;
+        size_t length = frame.length;
+
+        if (m_audioDecoder) {
+            if (frame.chunks > 1) {
+                // A codec frame split over several slots is only decodable as a whole, the parts are consecutive
+                if (frame.chunk == 0) {
+                    m_codecFrame.clear();
+                }
+                m_codecFrame.insert(m_codecFrame.end(), data, data + length);
+                if (frame.chunk + 1 < frame.chunks) {
+                    return;
+                }
+                data = m_codecFrame.data();
+                length = m_codecFrame.size();
+            }
+            m_decodeOut.clear();
+            if (!m_audioDecoder->Decode(data, length, m_decodeOut)) {
+                // Leave the gap to the sequence tracker, it conceals it like a lost frame
+                return;
+            }
+            data = m_decodeOut.data();
+            length = m_decodeOut.size();
+        }
+
+        // Metered as received, ahead of concealment and format conversion
+        if (m_levelMeter) {
+            m_levelMeter->Process(reinterpret_cast<const int16_t*>(data), length / WORD_SIZE);
+        }
+
+        if (frame.sequenceNo == 0) {
+            ForwardToStream(data, length, frame.enqueuedNs);
+        } else {
+            m_sequenceOut.clear();
+            // Decoded frames have been put back together already, only raw PCM reaches the tracker in parts
+            const bool continuation = (frame.chunk != 0 && !m_audioDecoder);
+            m_sequenceTracker->Push(frame.sequenceNo, continuation, data, length, m_sequenceOut);
+            ForwardToStream(m_sequenceOut.data(), m_sequenceOut.size(), frame.enqueuedNs);
+        }
+    }
+
+    bool SmartScreen::SetInputCodec(const AudioDecoder::Codec codec)
+    {
+        const std::lock_guard<std::mutex> lock{ m_inputFormatMutex };
+        if (!AudioDecoder::IsSupported(codec, m_inputRateHz, m_inputChannels)) {
+            XLOGD_ERROR("Input codec <%d> cannot be decoded at <%u Hz, %u channels>", static_cast<int>(codec), m_inputRateHz, m_inputChannels);
+            return false;
+        }
+        XLOGD_INFO("Input codec <%d> applies from the next session", static_cast<int>(codec));
+        m_inputCodec = codec;
+        return true;
+    }
+
+    bool SmartScreen::SetKeyword(const uint32_t sampleBegin, const uint32_t sampleEnd)
+    {
+        const std::lock_guard<std::mutex> lock{ m_inputFormatMutex };
+        m_keywordSet = sampleEnd > sampleBegin;
+        m_keywordBegin = sampleBegin;
+        m_keywordEnd = sampleEnd;
+        return true;
+    }
+
+    void SmartScreen::BeginWakeWord()
+    {
+        m_wakeWordPending = false;
+        if (!m_wakeWordSession) {
+            return;
+        }
+
+        uint64_t keywordBegin, keywordEnd;
+        {
+            const std::lock_guard<std::mutex> lock{ m_inputFormatMutex };
+            keywordBegin = m_keywordBegin;
+            keywordEnd = m_keywordEnd;
+        }
+
+        // Keyword offsets are input samples from the start of the stream, the SDS holds 16 kHz words
+        const uint64_t inputRateHz = m_formatConverter ? m_formatConverter->InputRateHz() : SAMPLE_RATE_HZ;
+        keywordBegin = keywordBegin * SAMPLE_RATE_HZ / inputRateHz;
+        keywordEnd = keywordEnd * SAMPLE_RATE_HZ / inputRateHz;
+        if (m_noiseSuppressor) {
+            keywordBegin += m_noiseSuppressor->DelaySamples();
+            keywordEnd += m_noiseSuppressor->DelaySamples();
+        }
+
+        if (keywordBegin < WAKE_WORD_PREROLL_SAMPLES) {
+            const std::vector<uint8_t> silence((WAKE_WORD_PREROLL_SAMPLES - keywordBegin) * WORD_SIZE, 0);
+            CommitToStream(silence.data(), silence.size(), true);
+        }
+
+        const alexaClientSDK::avsCommon::avs::AudioInputStream::Index streamBegin = v_writer->tell();
+        m_wakeWordBeginIndex = streamBegin + keywordBegin;
+        m_wakeWordEndIndex = streamBegin + keywordEnd;
+        m_wakeWordPending = true;
+    }
+
+    void SmartScreen::DispatchWakeWord(const bool flush)
+    {
+        if (!m_wakeWordPending) {
+            return;
+        }
+
+        const alexaClientSDK::avsCommon::avs::AudioInputStream::Index written = v_writer->tell();
+        if (written < m_wakeWordEndIndex) {
+            if (flush) {
+                XLOGD_WARN("Stream ended before the keyword, recognize not sent");
+                m_wakeWordPending = false;
+            }
+            return;
+        }
+        m_wakeWordPending = false;
+
+        const std::chrono::steady_clock::time_point keywordTime = std::chrono::steady_clock::now() -
+            std::chrono::milliseconds((written - m_wakeWordBeginIndex) * 1000 / SAMPLE_RATE_HZ);
+        XLOGD_INFO("Wake word recognize begin <%llu> end <%llu>", (unsigned long long)m_wakeWordBeginIndex, (unsigned long long)m_wakeWordEndIndex);
+        m_recognizeController->StartWakeWord(m_wakeAudioProvider, m_wakeWordBeginIndex, m_wakeWordEndIndex, WAKE_WORD_KEYWORD, keywordTime);
+    }
+
+    bool SmartScreen::SetInputFormat(const uint32_t sampleRateHz, const uint32_t numChannels)
+    {
+        if (!AudioFormatCompatibility::IsConvertible(sampleRateHz, numChannels)) {
+            return false;
+        }
+
+        const std::lock_guard<std::mutex> lock{ m_inputFormatMutex };
+        if (!AudioDecoder::IsSupported(m_inputCodec, sampleRateHz, numChannels)) {
+            XLOGD_ERROR("Input codec <%d> cannot be decoded at <%u Hz, %u channels>", static_cast<int>(m_inputCodec), sampleRateHz, numChannels);
+            return false;
+        }
+        XLOGD_INFO("Input format <%u Hz, %u channels> applies from the next session", sampleRateHz, numChannels);
+        m_inputRateHz = sampleRateHz;
+        m_inputChannels = numChannels;
+        return true;
+    }
+
+    void SmartScreen::ApplyInputFormat()
+    {
+        uint32_t sampleRateHz, numChannels;
+        AudioDecoder::Codec codec;
+        {
+            const std::lock_guard<std::mutex> lock{ m_inputFormatMutex };
+            sampleRateHz = m_inputRateHz;
+            numChannels = m_inputChannels;
+            codec = m_inputCodec;
+        }
+
+        // Opus decoders are built for one rate and channel count, so a format change needs a new decoder too
+        if (!m_audioDecoder || m_audioDecoder->GetCodec() != codec || m_audioDecoder->GetSampleRateHz() != sampleRateHz ||
+            m_audioDecoder->GetNumChannels() != numChannels) {
+            m_audioDecoder = AudioDecoder::create(codec, sampleRateHz, numChannels);
+        }
+        // Compressed bytes must never be written to the SDS as PCM, the session's frames are dropped instead
+        m_inputUndecodable = (!m_audioDecoder && codec != AudioDecoder::Codec::PCM_16);
+        if (m_inputUndecodable) {
+            XLOGD_ERROR("Failed to create the audio decoder, the session's audio is dropped");
+        }
+
+        if (sampleRateHz == AudioFormatCompatibility::SAMPLE_RATE_HZ && numChannels == AudioFormatCompatibility::NUM_CHANNELS) {
+            m_formatConverter.reset();
+            return;
+        }
+        if (m_formatConverter && m_formatConverter->InputRateHz() == sampleRateHz && m_formatConverter->InputChannels() == numChannels) {
+            return;
+        }
+
+        m_formatConverter = AudioFormatConverter::create(sampleRateHz, numChannels, AudioFormatCompatibility::SAMPLE_RATE_HZ);
+        if (!m_formatConverter) {
+            XLOGD_ERROR("Failed to create the format converter, audio is passed unconverted");
+        }
+    }
+
+    void SmartScreen::ForwardToStream(const uint8_t* data, size_t length, const uint64_t arrivalNs)
+    {
+        if (length == 0) {
+            return;
+        }
+        if (m_formatConverter) {
+            m_formatOut.clear();
+            m_formatConverter->Process(data, length, m_formatOut);
+            if (m_formatOut.empty()) {
+                return;
+            }
+            data = m_formatOut.data();
+            length = m_formatOut.size();
+        }
+        AdvanceCaptureTimeline(length / WORD_SIZE, arrivalNs);
+        // Ahead of the noise suppressor so the echo is removed before it can bias the noise estimate
+        if (m_echoCanceller) {
+            m_echoOut.clear();
+            m_echoCanceller->Process(data, length, arrivalNs, m_echoOut);
+            data = m_echoOut.data();
+            length = m_echoOut.size();
+        }
+        if (m_noiseSuppressor) {
+            m_suppressOut.clear();
+            m_noiseSuppressor->Process(data, length, m_suppressOut);
+            data = m_suppressOut.data();
+            length = m_suppressOut.size();
+        }
+        PlayoutToStream(data, length, arrivalNs);
+    }
+
+    void SmartScreen::PlayoutToStream(const uint8_t* data, const size_t length, const uint64_t arrivalNs)
+    {
+        if (length == 0) {
+            return;
+        }
+        // Analysed ahead of the jitter buffer so its delay is not added to the end-pointing latency
+        if (m_vad && m_vad->Process(reinterpret_cast<const int16_t*>(data), length / WORD_SIZE)) {
+            OnEndOfSpeech();
+        }
+        if (m_jitterBuffer) {
+            m_jitterBuffer->Push(data, length, arrivalNs);
+        } else {
+            WriteToStream(data, length);
+        }
+    }
+
+    void SmartScreen::WriteToStream(const uint8_t data[], const size_t length)
+    {
+        if (m_silenceTrimmer) {
+            m_trimOut.clear();
+            m_silenceTrimmer->Process(data, length, m_trimOut);
+            if (m_trimOut.empty()) {
+                return;
+            }
+            EncodeToStream(m_trimOut.data(), m_trimOut.size());
+        } else {
+            EncodeToStream(data, length);
+        }
+    }
+
+    void SmartScreen::EncodeToStream(const uint8_t data[], const size_t length)
+    {
+        // Upload sample n is session sample n shifted by the trimmed lead and the noise suppressor delay. Audio
+        // held back by the encoder is counted as written, it is at most one Opus frame.
+        m_uploadSamples += length / WORD_SIZE;
+        uint64_t sessionSamples = m_uploadSamples;
+        if (m_silenceTrimmer) {
+            sessionSamples += static_cast<uint64_t>(m_silenceTrimmer->GetStats().trimmedMs) * SAMPLE_RATE_HZ / 1000;
+        }
+        if (m_noiseSuppressor) {
+            sessionSamples -= std::min<uint64_t>(sessionSamples, m_noiseSuppressor->DelaySamples());
+        }
+        m_commitCaptureNs = CaptureTimeNs(sessionSamples);
+
+        if (m_audioEncoder) {
+            m_encodeOut.clear();
+            m_audioEncoder->Encode(data, length, m_encodeOut);
+            CommitToStream(m_encodeOut.data(), m_encodeOut.size());
+        } else {
+            CommitToStream(data, length);
+        }
+    }
+
+    // Synthetic audio (the wake word pre-roll silence) was never captured, it is kept out of the timeline and trace
+    void SmartScreen::CommitToStream(const uint8_t data[], const size_t length, const bool synthetic)
     {
-		XLOGD_DEBUG("AVS voice data...");
-		
         if (v_writer) {
             size_t nWords = length / v_writer->getWordSize();
+            if (nWords == 0) {
+                return;
+            }
+            const uint64_t wordIndex = v_writer->tell();
             ssize_t rc = v_writer->write(data, nWords);
             if (rc <= 0) {
                 XLOGD_ERROR("Failed to write to stream with rc = %d", rc);
+                const uint64_t words = nWords;
+                FlightRecorder::instance()->Record(FlightRecorder::Type::SDS_OVERRUN, static_cast<uint32_t>(rc), &words, sizeof(words));
+                return;
+            }
+            if (synthetic) {
+                return;
+            }
+            if (!m_sessionWritten) {
+                m_sessionWritten = true;
+                SessionTracer::instance()->Trace(SessionTracer::Event::FIRST_SDS_WRITE);
+            }
+            if (m_captureIndex && m_commitCaptureNs != 0) {
+                AudioCaptureIndex::Entry entry;
+                entry.wordIndex = wordIndex;
+                entry.wordCount = static_cast<uint64_t>(rc);
+                entry.captureNs = m_commitCaptureNs;
+                entry.writtenNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+                m_captureIndex->Add(entry);
+                if (entry.writtenNs > entry.captureNs) {
+                    m_writeLatency->Record(entry.writtenNs - entry.captureNs);
+                }
             }
         }
 		else
@@ -745,7 +1986,6 @@ namespace WPEFramework {
 			 XLOGD_ERROR("v_writer is null");
 		}
     }		
-
 }
 
 
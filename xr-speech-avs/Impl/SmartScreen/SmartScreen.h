@@ -29,11 +29,30 @@
 #include <SmartScreen/SampleApp/SampleApplication.h>
 #include "ThunderVoiceHandler.h"
 #include "ThunderInputManager.h"
+#include "AudioStagingQueue.h"
+#include "AudioJitterBuffer.h"
+#include "AudioSequenceTracker.h"
+#include "AudioFormatConverter.h"
+#include "AudioDecoder.h"
+#include "AudioEncoder.h"
+#include "RecognizeController.h"
+#include "AudioVad.h"
+#include "AudioSilenceTrimmer.h"
+#include "AudioNoiseSuppressor.h"
+#include "AudioReference.h"
+#include "AudioEchoCanceller.h"
+#include "AudioLevelMeter.h"
+#include "AudioCaptureIndex.h"
+#include "AudioLatencyHistogram.h"
 #include <WPEFramework/core/core.h>
 
 #include <VoiceToApps/VoiceToApps.h>
 #include <VoiceToApps/VideoSkillInterface.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace WPEFramework {
@@ -45,9 +64,54 @@ namespace WPEFramework {
     public:
         SmartScreen()
             :v_writer(nullptr)
-			,aspInputInteractionHandler(nullptr),m_isStarted(false)
+			,m_isStarted(false)
             , m_thunderInputManager(nullptr)
             , m_thunderVoiceHandler(nullptr)
+            , m_stagingQueue(nullptr)
+            , m_sdsWriterRunning(false)
+            , m_flushRequested(false)
+            , m_sessionBegin(false)
+            , m_jitterBuffer(nullptr)
+            , m_sequenceTracker(nullptr)
+            , m_formatConverter(nullptr)
+            , m_inputRateHz(AudioFormatCompatibility::SAMPLE_RATE_HZ)
+            , m_inputChannels(AudioFormatCompatibility::NUM_CHANNELS)
+            , m_audioDecoder(nullptr)
+            , m_inputUndecodable(false)
+            , m_inputCodec(AudioDecoder::Codec::PCM_16)
+            , m_audioEncoder(nullptr)
+            , m_recognizeController(nullptr)
+            , m_wakeAudioProvider(alexaClientSDK::capabilityAgents::aip::AudioProvider::null())
+            , m_keywordSet(false)
+            , m_keywordBegin(0)
+            , m_keywordEnd(0)
+            , m_wakeWordSession(false)
+            , m_wakeWordPending(false)
+            , m_wakeWordBeginIndex(0)
+            , m_wakeWordEndIndex(0)
+            , m_vad(nullptr)
+            , m_endpointLocal(false)
+            , m_endOfSpeechHandler(nullptr)
+            , m_endOfSpeechUserData(nullptr)
+            , m_endOfSpeechNs(0)
+            , m_endpointStats()
+            , m_silenceTrimmer(nullptr)
+            , m_noiseSuppressor(nullptr)
+            , m_audioReference(nullptr)
+            , m_echoCanceller(nullptr)
+            , m_levelMeter(nullptr)
+            , m_streamBeginNs(0)
+            , m_captureBaseNs(0)
+            , m_captureSamples(0)
+            , m_uploadSamples(0)
+            , m_commitCaptureNs(0)
+            , m_captureIndex(nullptr)
+            , m_writeLatency(nullptr)
+            , m_uploadLatency(nullptr)
+            , m_lastUploadUs(0)
+            , m_sessionWritten(false)
+            , m_recordedEnqueued(0)
+            , m_recordedStatsNs(0)
         {
            Run();
         }
@@ -57,6 +121,7 @@ namespace WPEFramework {
         ~SmartScreen()
         {
             Stop();
+            StopSdsWriter();
             Wait(Thread::STOPPED | Thread::BLOCKED, Core::infinite);
         }
         void CreateSQSWorker(void)
@@ -87,16 +152,150 @@ namespace WPEFramework {
         bool JsonConfigToStream(std::vector<std::shared_ptr<std::istream>>& streams, const std::string& configFile);
 
     public:
+        /// Local end-pointer result of the last session and totals since start up
+        struct EndpointStats {
+            uint32_t speechMs;
+            uint32_t endOfSpeechMs;
+            uint32_t savedMs;         ///< Time between the local end of speech and the end of the stream
+            bool endOfSpeech;
+            uint32_t endpoints;
+            uint64_t savedMsTotal;
+        };
+        typedef void (*EndOfSpeechHandler)(void* userData);
+
+        /// Capture to SDS write latency of every write and capture to upload latency of the last sample of each
+        /// recognize, since start up
+        struct LatencyStats {
+            AudioLatencyHistogram::Stats captureToWrite;
+            AudioLatencyHistogram::Stats captureToUpload;
+            uint32_t lastUploadUs;
+        };
+
 		void Start();
 		void Stop();
-		void Data(const uint32_t sequenceNo, const uint8_t data[], const uint16_t length);
+		void Cancel();
+		uint32_t Data(const uint32_t sequenceNo, const struct iovec frames[], const uint32_t count);
+        bool GetQueueStats(AudioStagingQueue::Stats& stats) const;
+        bool GetJitterStats(AudioJitterBuffer::Stats& stats);
+        bool GetSequenceStats(AudioSequenceTracker::Stats& stats);
+        bool SetInputFormat(const uint32_t sampleRateHz, const uint32_t numChannels);
+        bool SetInputCodec(const AudioDecoder::Codec codec);
+        bool GetEncoderStats(AudioEncoder::Stats& stats);
+        bool GetRecognizeStats(RecognizeController::Stats& stats);
+        bool SetKeyword(const uint32_t sampleBegin, const uint32_t sampleEnd);
+        void SetEndOfSpeechHandler(EndOfSpeechHandler handler, void* userData);
+        bool GetEndpointStats(EndpointStats& stats);
+        bool GetTrimStats(AudioSilenceTrimmer::Stats& stats);
+        bool GetNoiseSuppressorStats(AudioNoiseSuppressor::Stats& stats);
+        bool GetEchoCancellerStats(AudioEchoCanceller::Stats& stats);
+        bool GetLevelStats(AudioLevelMeter::Stats& stats) const;
+        void SetStreamBeginTime(const uint64_t timeNs);
+        bool GetLatencyStats(LatencyStats& stats);
+        bool GetDispatchStats(DispatchQueue::Stats& stats) const;
+
+    private:
+        bool InitJitterBuffer(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config);
+        bool InitUploadEncoder(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config);
+        bool InitDispatchQueue(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config);
+        bool InitFlightRecorder(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config);
+        bool InitEchoCanceller(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config);
+        bool InitNoiseSuppressor(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config);
+        bool InitSilenceTrimmer(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config);
+        bool InitEndpointer(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config);
+        bool InitSequenceTracker(alexaClientSDK::avsCommon::utils::configuration::ConfigurationNode config);
+        bool StartSdsWriter();
+        void StopSdsWriter();
+        void FlushSdsWriter();
+        void SdsWriterWorker();
+        void ApplyInputFormat();
+        void BeginWakeWord();
+        void DispatchWakeWord(const bool flush);
+        void OnEndOfSpeech();
+        void OnCaptureClosed(const std::chrono::steady_clock::time_point closedTime);
+        void BeginCaptureTimeline();
+        void AdvanceCaptureTimeline(const size_t samples, const uint64_t arrivalNs);
+        uint64_t CaptureTimeNs(const uint64_t sample) const;
+        void UpdateEndpointStats();
+        void ProcessFrame(const AudioStagingQueue::Frame& frame);
+        void ForwardToStream(const uint8_t* data, size_t length, const uint64_t arrivalNs);
+        void PlayoutToStream(const uint8_t* data, const size_t length, const uint64_t arrivalNs);
+        void WriteToStream(const uint8_t data[], const size_t length);
+        void EncodeToStream(const uint8_t data[], const size_t length);
+        void CommitToStream(const uint8_t data[], const size_t length, const bool synthetic = false);
 
     private:
         std::shared_ptr<ThunderInputManager> m_thunderInputManager;
         std::shared_ptr<ThunderVoiceHandler<alexaSmartScreenSDK::sampleApp::gui::GUIManager>> m_thunderVoiceHandler;
 	    std::shared_ptr<alexaClientSDK::avsCommon::avs::AudioInputStream::Writer> v_writer;
-        std::shared_ptr<InteractionHandler<alexaSmartScreenSDK::sampleApp::gui::GUIManager>> aspInputInteractionHandler;		
         bool m_isStarted;
+        std::unique_ptr<AudioStagingQueue> m_stagingQueue;
+        std::thread m_sdsWriterThread;
+        std::atomic_bool m_sdsWriterRunning;
+        std::atomic_bool m_flushRequested;
+        std::mutex m_flushMutex;
+        std::condition_variable m_flushDone;
+        std::atomic_bool m_sessionBegin;
+        std::unique_ptr<AudioJitterBuffer> m_jitterBuffer;
+        std::vector<uint8_t> m_jitterOut;
+        std::unique_ptr<AudioSequenceTracker> m_sequenceTracker;
+        std::vector<uint8_t> m_sequenceOut;
+        std::unique_ptr<AudioFormatConverter> m_formatConverter;
+        std::vector<uint8_t> m_formatOut;
+        std::mutex m_inputFormatMutex;
+        uint32_t m_inputRateHz;
+        uint32_t m_inputChannels;
+        std::unique_ptr<AudioDecoder> m_audioDecoder;
+        bool m_inputUndecodable;
+        std::vector<uint8_t> m_decodeOut;
+        std::vector<uint8_t> m_codecFrame;
+        AudioDecoder::Codec m_inputCodec;
+        std::unique_ptr<AudioEncoder> m_audioEncoder;
+        std::vector<uint8_t> m_encodeOut;
+        AudioEncoder::Stats m_encoderStats;
+        std::mutex m_ingestStatsMutex;
+        AudioJitterBuffer::Stats m_jitterStats;
+        AudioSequenceTracker::Stats m_sequenceStats;
+        std::shared_ptr<RecognizeController> m_recognizeController;
+        alexaClientSDK::capabilityAgents::aip::AudioProvider m_wakeAudioProvider;
+        bool m_keywordSet;
+        uint32_t m_keywordBegin;
+        uint32_t m_keywordEnd;
+        std::atomic_bool m_wakeWordSession;
+        bool m_wakeWordPending;
+        alexaClientSDK::avsCommon::avs::AudioInputStream::Index m_wakeWordBeginIndex;
+        alexaClientSDK::avsCommon::avs::AudioInputStream::Index m_wakeWordEndIndex;
+        std::unique_ptr<AudioVad> m_vad;
+        bool m_endpointLocal;
+        std::mutex m_endOfSpeechMutex;
+        EndOfSpeechHandler m_endOfSpeechHandler;
+        void* m_endOfSpeechUserData;
+        std::atomic<uint64_t> m_endOfSpeechNs;
+        std::unique_ptr<DispatchQueue> m_endOfSpeechQueue;
+        EndpointStats m_endpointStats;
+        std::unique_ptr<AudioSilenceTrimmer> m_silenceTrimmer;
+        std::vector<uint8_t> m_trimOut;
+        AudioSilenceTrimmer::Stats m_trimStats;
+        std::unique_ptr<AudioNoiseSuppressor> m_noiseSuppressor;
+        std::vector<uint8_t> m_suppressOut;
+        AudioNoiseSuppressor::Stats m_noiseSuppressorStats;
+        std::shared_ptr<AudioReference> m_audioReference;
+        std::unique_ptr<AudioEchoCanceller> m_echoCanceller;
+        std::vector<uint8_t> m_echoOut;
+        AudioEchoCanceller::Stats m_echoCancellerStats;
+        std::unique_ptr<AudioLevelMeter> m_levelMeter;
+        std::atomic<uint64_t> m_streamBeginNs;
+        uint64_t m_captureBaseNs;
+        uint64_t m_captureSamples;
+        uint64_t m_uploadSamples;
+        uint64_t m_commitCaptureNs;
+        std::unique_ptr<AudioCaptureIndex> m_captureIndex;
+        std::unique_ptr<AudioLatencyHistogram> m_writeLatency;
+        AudioLatencyHistogram::Stats m_writeLatencyStats;
+        std::unique_ptr<AudioLatencyHistogram> m_uploadLatency;
+        uint32_t m_lastUploadUs;
+        bool m_sessionWritten;
+        uint64_t m_recordedEnqueued;
+        uint64_t m_recordedStatsNs;
     };
 
 
@@ -26,9 +26,12 @@
  */
 
 #include "ThunderInputManager.h"
+#include "SessionTracer.h"
+#include "FlightRecorder.h"
 
-namespace WPEFramework {
+#include <cstdio>
 
+namespace WPEFramework {
 
     using namespace alexaClientSDK::avsCommon::sdkInterfaces;
 
@@ -104,6 +107,7 @@ namespace WPEFramework {
        case PlayerActivity::PLAYING:
            std::cout << "playing ";
            smState = AudioPlayerState::PLAYING; 
+           SessionTracer::instance()->Trace(SessionTracer::Event::FIRST_PLAYING);
            break;
        case PlayerActivity::STOPPED:
           std::cout << "stopped" ;
@@ -133,6 +137,16 @@ namespace WPEFramework {
 
     void ThunderInputManager::onDialogUXStateChanged(DialogUXState newState)
     {
+        FlightRecorder::instance()->Record(FlightRecorder::Type::DIALOG_STATE, static_cast<uint32_t>(newState));
+        switch (newState) {
+        case DialogUXState::IDLE:      SessionTracer::instance()->Trace(SessionTracer::Event::DIALOG_IDLE);      break;
+        case DialogUXState::LISTENING: SessionTracer::instance()->Trace(SessionTracer::Event::DIALOG_LISTENING); break;
+        case DialogUXState::EXPECTING: SessionTracer::instance()->Trace(SessionTracer::Event::DIALOG_EXPECTING); break;
+        case DialogUXState::THINKING:  SessionTracer::instance()->Trace(SessionTracer::Event::DIALOG_THINKING);  break;
+        case DialogUXState::SPEAKING:  SessionTracer::instance()->Trace(SessionTracer::Event::DIALOG_SPEAKING);  break;
+        case DialogUXState::FINISHED:  SessionTracer::instance()->Trace(SessionTracer::Event::DIALOG_FINISHED);  break;
+        default: break;
+        }
 
         NotifyDialogUXStateChanged(newState);
 
@@ -146,7 +160,7 @@ namespace WPEFramework {
         }
 
         XLOGD_DEBUG("VoiceToApps template card: %s ...\n", jsonPayload.c_str());
-        vta.curlCmdSendOnRcvMsg(jsonPayload);
+        SendToApps(DispatchQueue::Priority::NORMAL, "templateCard", jsonPayload);
     }
 
     void  ThunderInputManager::renderPlayerInfoCard (const std::string &jsonPayload, 
@@ -163,19 +177,86 @@ namespace WPEFramework {
 
     }
 
+    // Directives acted on here, looked up by namespace and name
+    const ThunderInputManager::DirectiveRoute ThunderInputManager::DIRECTIVE_ROUTES[] = {
+        { "SpeechSynthesizer", "Speak", &ThunderInputManager::OnSpeakDirective }
+    };
+
     void ThunderInputManager::receive(const std::string& contextId, const std::string& message) {
         XLOGD_DEBUG( "Message received from observer..");
 
+        DirectiveHeader header;
+        if (!header.Parse(message.data(), message.size())) {
+            XLOGD_DEBUG("Not a directive");
+            return;
+        }
+
+        char directiveName[FlightRecorderFormat::PAYLOAD_SIZE];
+        snprintf(directiveName, sizeof(directiveName), "%.*s.%.*s", static_cast<int>(header.nameSpace.size), header.nameSpace.data,
+            static_cast<int>(header.name.size), header.name.data);
+        FlightRecorder::instance()->RecordText(FlightRecorder::Type::DIRECTIVE, 0, directiveName);
+
+        for (const auto& route : DIRECTIVE_ROUTES) {
+            if (header.nameSpace == route.nameSpace && header.name == route.name) {
+                (this->*route.handler)(header, message);
+                return;
+            }
+        }
+    }
+
+    void ThunderInputManager::OnSpeakDirective(const DirectiveHeader& header, const std::string& message)
+    {
+        SessionTracer::instance()->Trace(SessionTracer::Event::SPEAK_DIRECTIVE);
+
         if(! m_vtaFlag ) {
             XLOGD_ERROR("VoiceToApps vtaFlag not initialized...");
             return;
         }
 
-        std::string key = "\"namespace\":\"SpeechSynthesizer\",\"name\":\"Speak\"";
-        if(std::string::npos!=message.find(key,0) ){
+        // Copied once here and shared by VoiceToApps and the avs_sdt consumer from then on
+        DirectiveRef directive(Directive::create(message, header));
+
+        // Ahead of template cards, the app acts on it before the TTS plays
+        SendToApps(DispatchQueue::Priority::HIGH, "speak", directive);
+        avs_server_directive(directive.get()->Handle());
+    }
+
+    bool ThunderInputManager::StartDispatch(const DispatchQueue::Config& config)
+    {
+        if (m_dispatchQueue) {
+            return true;
+        }
+        m_dispatchQueue = DispatchQueue::create(config);
+        return m_dispatchQueue != nullptr;
+    }
+
+    bool ThunderInputManager::GetDispatchStats(DispatchQueue::Stats& stats) const
+    {
+        if (!m_dispatchQueue) {
+            return false;
+        }
+        stats = m_dispatchQueue->GetStats();
+        return true;
+    }
+
+    // The HTTP request to the app, and so any connection reuse, is made inside VoiceToApps. The per-message
+    // dispatch time reported by the queue includes its connection set up.
+    void ThunderInputManager::SendToApps(const DispatchQueue::Priority priority, const std::string& target, const std::string& message)
+    {
+        if (!m_dispatchQueue) {
             vta.curlCmdSendOnRcvMsg(message);
-			avs_server_msg(message.c_str(), (unsigned long)message.length());
-		}
+            return;
+        }
+        m_dispatchQueue->Post(priority, target, [this, message]() { vta.curlCmdSendOnRcvMsg(message); });
+    }
+
+    void ThunderInputManager::SendToApps(const DispatchQueue::Priority priority, const std::string& target, const DirectiveRef& directive)
+    {
+        if (!m_dispatchQueue) {
+            vta.curlCmdSendOnRcvMsg(directive->Raw());
+            return;
+        }
+        m_dispatchQueue->Post(priority, target, [this, directive]() { vta.curlCmdSendOnRcvMsg(directive->Raw()); });
     }
 
     void ThunderInputManager::NotifyDialogUXStateChanged(DialogUXState newState)
@@ -26,6 +26,8 @@
 #include <VoiceToApps/VoiceToApps.h>
 #include <VoiceToApps/VideoSkillInterface.h>
 #include <rdkx_logger.h>
+#include "DispatchQueue.h"
+#include "Directive.h"
 
 #include <AVS/SampleApp/InteractionManager.h>
 #include <AVSCommon/SDKInterfaces/MessageObserverInterface.h>
@@ -75,6 +77,10 @@ namespace WPEFramework {
 
 		void NotifyDialogUXStateChanged(DialogUXState newState);
 
+        /// Moves the VoiceToApps calls off the SDK observer threads, they are made synchronously until then
+        bool StartDispatch(const DispatchQueue::Config& config);
+        bool GetDispatchStats(DispatchQueue::Stats& stats) const;
+
     private:
         ThunderInputManager(std::shared_ptr<alexaClientSDK::sampleApp::InteractionManager> interactionManager);
 #if defined(ENABLE_SMART_SCREEN_SUPPORT)
@@ -82,12 +88,25 @@ namespace WPEFramework {
 #endif
         void onAuthStateChange(AuthObserverInterface::State newState, AuthObserverInterface::Error newError) override;
 		void onCapabilitiesStateChange (CapabilitiesDelegateObserverInterface::State newState, CapabilitiesDelegateObserverInterface::Error newError, const std::vector< std::string > &addedOrUpdatedEndpointIds, const std::vector< std::string > &deletedEndpointIds) override;
+        void SendToApps(const DispatchQueue::Priority priority, const std::string& target, const std::string& message);
+        void SendToApps(const DispatchQueue::Priority priority, const std::string& target, const DirectiveRef& directive);
+
+        using DirectiveHandler = void (ThunderInputManager::*)(const DirectiveHeader& header, const std::string& message);
+        struct DirectiveRoute {
+            const char* nameSpace;
+            const char* name;
+            DirectiveHandler handler;
+        };
+        static const DirectiveRoute DIRECTIVE_ROUTES[];
+
+        void OnSpeakDirective(const DirectiveHeader& header, const std::string& message);
 
         std::shared_ptr<alexaClientSDK::sampleApp::InteractionManager> m_interactionManager;
        #if defined(ENABLE_SMART_SCREEN_SUPPORT)
                std::shared_ptr<alexaSmartScreenSDK::sampleApp::gui::GUIManager> m_guiManager;
        #endif
         std::atomic_bool m_limitedInteraction;
+        std::unique_ptr<DispatchQueue> m_dispatchQueue;
     };
 
 
@@ -22,6 +22,9 @@
  */
 
 #include "ThunderLogger.h"
+#include "FlightRecorder.h"
+
+#include <cstring>
 
 namespace WPEFramework {
 
@@ -31,19 +34,124 @@ namespace WPEFramework {
     using namespace alexaClientSDK::avsCommon::utils::logger;
 
     static const std::string CONFIG_KEY_DEFAULT_LOGGER = "thunderLogger";
+    // About 256 KB of entries, absorbs a burst of DEBUG9 lines while the writer catches up
+    static const size_t LOG_WRITER_ENTRIES = 256;
 
     std::shared_ptr<Logger> ThunderLogger::instance()
     {
-        static std::shared_ptr<Logger> singleThunderLogger = std::shared_ptr<ThunderLogger>(new ThunderLogger);
+        return thunderInstance();
+    }
+
+    std::shared_ptr<ThunderLogger> ThunderLogger::thunderInstance()
+    {
+        static std::shared_ptr<ThunderLogger> singleThunderLogger = std::shared_ptr<ThunderLogger>(new ThunderLogger);
         return singleThunderLogger;
     }
 
     ThunderLogger::ThunderLogger()
         : Logger(Level::UNKNOWN)
+        , m_writer(AsyncLogWriter::create(LOG_WRITER_ENTRIES))
+        , m_globalLevel(static_cast<int>(Level::UNKNOWN))
+        , m_tagCount(0)
     {
         init(configuration::ConfigurationNode::getRoot()[CONFIG_KEY_DEFAULT_LOGGER]);
     }
 
+    void ThunderLogger::SetLogLevel(Level level)
+    {
+        thunderInstance()->setLevel(level);
+    }
+
+    bool ThunderLogger::SetTagLogLevel(const std::string& tag, Level level)
+    {
+        std::shared_ptr<ThunderLogger> logger = thunderInstance();
+        if (tag.empty() || tag.size() >= TAG_MAX) {
+            return false;
+        }
+
+        const std::lock_guard<std::mutex> lock{ logger->m_levelMutex };
+        const size_t count = logger->m_tagCount.load(std::memory_order_relaxed);
+        size_t index = 0;
+        while (index < count && tag != logger->m_tagLevels[index].tag) {
+            index++;
+        }
+        if (index == count) {
+            if (count == TAG_LEVELS_MAX) {
+                return false;
+            }
+            // Published by the count, readers never see a partially written tag
+            std::strcpy(logger->m_tagLevels[index].tag, tag.c_str());
+            logger->m_tagLevels[index].level.store(static_cast<int>(level), std::memory_order_relaxed);
+            logger->m_tagCount.store(count + 1, std::memory_order_release);
+        } else {
+            logger->m_tagLevels[index].level.store(static_cast<int>(level), std::memory_order_relaxed);
+        }
+        logger->ApplySinkLevel();
+        return true;
+    }
+
+    void ThunderLogger::ClearTagLogLevel(const std::string& tag)
+    {
+        std::shared_ptr<ThunderLogger> logger = thunderInstance();
+
+        const std::lock_guard<std::mutex> lock{ logger->m_levelMutex };
+        const size_t count = logger->m_tagCount.load(std::memory_order_relaxed);
+        for (size_t index = 0; index < count; index++) {
+            if (tag == logger->m_tagLevels[index].tag) {
+                logger->m_tagLevels[index].level.store(LEVEL_CLEARED, std::memory_order_relaxed);
+            }
+        }
+        logger->ApplySinkLevel();
+    }
+
+    void ThunderLogger::setLevel(Level level)
+    {
+        const std::lock_guard<std::mutex> lock{ m_levelMutex };
+        m_globalLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+        ApplySinkLevel();
+    }
+
+    // The SDK only builds entries at or above the sink level, so it has to be the most verbose level in use.
+    // The module loggers follow it through their log level observer. A module logger cannot be more verbose than
+    // the sink, so one verbose tag makes every module build entries at that level for emit to throw away.
+    void ThunderLogger::ApplySinkLevel()
+    {
+        int sinkLevel = m_globalLevel.load(std::memory_order_relaxed);
+        const size_t count = m_tagCount.load(std::memory_order_relaxed);
+        for (size_t index = 0; index < count; index++) {
+            const int level = m_tagLevels[index].level.load(std::memory_order_relaxed);
+            if (level != LEVEL_CLEARED && level < sinkLevel) {
+                sinkLevel = level;
+            }
+        }
+        Logger::setLevel(static_cast<Level>(sinkLevel));
+    }
+
+    int ThunderLogger::ThresholdOf(const char* text) const
+    {
+        const size_t count = m_tagCount.load(std::memory_order_acquire);
+        if (count == 0) {
+            return m_globalLevel.load(std::memory_order_relaxed);
+        }
+
+        // Entries are "<tag>:<event>:<key>=<value>,..."
+        const char* end = static_cast<const char*>(std::memchr(text, ':', strnlen(text, TAG_MAX)));
+        if (end != nullptr) {
+            const size_t length = end - text;
+            for (size_t index = 0; index < count; index++) {
+                const TagLevel& tagLevel = m_tagLevels[index];
+                if (std::strncmp(tagLevel.tag, text, length) == 0 && tagLevel.tag[length] == '\0') {
+                    const int level = tagLevel.level.load(std::memory_order_relaxed);
+                    if (level != LEVEL_CLEARED) {
+                        return level;
+                    }
+                    break;
+                }
+            }
+        }
+        return m_globalLevel.load(std::memory_order_relaxed);
+    }
+
     void ThunderLogger::Trace(const std::string& stringToPrint)
     {
         XLOGD_DEBUG("AVSClient - %s", stringToPrint.c_str());
@@ -79,10 +187,20 @@ namespace WPEFramework {
         const char* threadMoniker,
         const char* text)
     {
+        // Filtered before anything is copied or formatted
+        if (static_cast<int>(level) < ThresholdOf(text)) {
+            return;
+        }
 
-        std::stringstream ss;
-        ss << "[" << threadMoniker << "] " << convertLevelToChar(level) << " " << text;
-        XLOGD_DEBUG(ss.str().c_str());
+        if (level == Level::ERROR || level == Level::CRITICAL) {
+            FlightRecorder::instance()->RecordText(FlightRecorder::Type::ERROR, static_cast<uint32_t>(level), text);
+        }
+
+        if (m_writer) {
+            m_writer->Post(convertLevelToChar(level), threadMoniker, text);
+        } else {
+            XLOGD_DEBUG("[%s] %c %s", threadMoniker, convertLevelToChar(level), text);
+        }
     }
 
 
@@ -26,6 +26,9 @@
 
 #include <AVSCommon/Utils/Logger/Logger.h>
 
+#include "AsyncLogWriter.h"
+
+#include <atomic>
 #include <mutex>
 #include <string>
 
@@ -33,7 +36,13 @@ namespace WPEFramework {
 
 
     /**
-     * Handles AVS SDK logs through Thunder Tracing
+     * Handles AVS SDK logs through Thunder Tracing. Lines are handed to an AsyncLogWriter so the SDK threads
+     * never wait on formatting or the logger backend.
+     *
+     * Levels can be changed at run time, globally or for a source tag (the LogEntry source, e.g.
+     * "AudioInputProcessor"). The SDK builds entries down to the most verbose of these levels, each line is
+     * then checked against the level of its tag before it is copied. Every source therefore pays the cost of
+     * formatting entries down to the most verbose tag level, the lines of other tags are only discarded here.
     */
     class ThunderLogger : public alexaClientSDK::avsCommon::utils::logger::Logger {
     public:
@@ -47,11 +56,40 @@ namespace WPEFramework {
         static void PrettyTrace(std::initializer_list<std::string> lines);
         static void Log(const std::string& stringToPrint);
         static void Log(std::initializer_list<std::string> lines);
+        /// Level of lines whose tag has no level of its own
+        static void SetLogLevel(alexaClientSDK::avsCommon::utils::logger::Level level);
+        /// Returns false if the tag is empty or too long, or the tag table is full
+        static bool SetTagLogLevel(const std::string& tag, alexaClientSDK::avsCommon::utils::logger::Level level);
+        static void ClearTagLogLevel(const std::string& tag);
+
+        void setLevel(alexaClientSDK::avsCommon::utils::logger::Level level) override;
         void emit(alexaClientSDK::avsCommon::utils::logger::Level level, std::chrono::system_clock::time_point time,
             const char* threadMoniker, const char* text) override;
 
     private:
+        static constexpr size_t TAG_LEVELS_MAX = 32;
+        static constexpr size_t TAG_MAX = 48;
+        static constexpr int LEVEL_CLEARED = -1;
+
+        /// Entries are only ever added, a cleared tag keeps its slot with LEVEL_CLEARED
+        struct TagLevel {
+            char tag[TAG_MAX];
+            std::atomic<int> level;
+        };
+
         ThunderLogger();
+
+        static std::shared_ptr<ThunderLogger> thunderInstance();
+
+        int ThresholdOf(const char* text) const;
+        void ApplySinkLevel();
+
+    private:
+        std::unique_ptr<AsyncLogWriter> m_writer;
+        std::mutex m_levelMutex;
+        std::atomic<int> m_globalLevel;
+        TagLevel m_tagLevels[TAG_LEVELS_MAX];
+        std::atomic<size_t> m_tagCount;
     };
 
 
@@ -0,0 +1,66 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+// Timing helpers shared by the avs-bench-* tools. Numbers are only comparable between runs on the same box.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdint.h>
+
+namespace Bench {
+
+    static inline uint64_t NowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// Keeps results alive so the compiler cannot drop the measured work
+    static volatile uint32_t sink;
+
+    /// First argument as a positive count, or the default
+    static inline uint32_t Count(int argc, char* argv[], const uint32_t defaultCount)
+    {
+        const long count = (argc > 1 ? strtol(argv[1], nullptr, 10) : 0);
+        return (count > 0 ? static_cast<uint32_t>(count) : defaultCount);
+    }
+
+    /// Runs body iterations times after a warm-up of a tenth of that and returns the mean ns per iteration
+    template <typename Body>
+    static double Measure(const uint32_t iterations, Body body)
+    {
+        for (uint32_t index = 0; index < iterations / 10; index++) {
+            body();
+        }
+        const uint64_t start = NowNs();
+        for (uint32_t index = 0; index < iterations; index++) {
+            body();
+        }
+        return static_cast<double>(NowNs() - start) / iterations;
+    }
+
+    static inline void Report(const char* name, const double nsPerIteration, const double unitsPerIteration, const char* units)
+    {
+        printf("%-32s %10.1f ns/op %12.2f M%s/s\n", name, nsPerIteration, unitsPerIteration * 1000.0 / nsPerIteration, units);
+    }
+
+} // namespace Bench
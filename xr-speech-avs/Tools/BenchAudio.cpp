@@ -0,0 +1,240 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Measures the ingest audio stages on the SDS writer thread, one stage at a time on 20 ms frames of a synthetic
+// voice-band signal. Samples/s are input samples per core, "x real time" is how many streams one core could carry.
+// Opus stages only run when Opus support is compiled in. The encoder rows also give the audio bytes a 5 s utterance
+// uploads in the recognize event, HTTP/2 framing not included.
+// Usage: avs-bench-audio [frames]
+
+#include "Bench.h"
+
+#include "AudioDecoder.h"
+#include "AudioEncoder.h"
+#include "AudioFormatConverter.h"
+#include "AudioNoiseSuppressor.h"
+
+#include <cmath>
+#include <vector>
+
+#if defined(OPUS_SUPPORT)
+#include <opus.h>
+#endif
+
+using namespace WPEFramework;
+
+static const uint32_t FRAME_MS = 20;
+static const uint32_t VOICE_RATE_HZ = 16000;
+static const size_t VOICE_FRAME_SAMPLES = VOICE_RATE_HZ * FRAME_MS / 1000;
+static const uint32_t UTTERANCE_MS = 5000;
+
+/// Interleaved 16-bit PCM, a few harmonics plus noise so no stage sees silence
+static std::vector<uint8_t> MakeSignal(const uint32_t sampleRateHz, const uint32_t channels, const uint32_t frames)
+{
+    const size_t samples = static_cast<size_t>(sampleRateHz) * FRAME_MS / 1000 * frames;
+    std::vector<uint8_t> signal(samples * channels * sizeof(int16_t));
+    int16_t* pcm = reinterpret_cast<int16_t*>(signal.data());
+    uint32_t seed = 1;
+    for (size_t index = 0; index < samples; index++) {
+        const double t = static_cast<double>(index) / sampleRateHz;
+        seed = seed * 1664525u + 1013904223u;
+        const double value = 6000.0 * sin(2 * M_PI * 220 * t) + 3000.0 * sin(2 * M_PI * 1330 * t) + static_cast<int32_t>(seed >> 20) - 2048;
+        for (uint32_t channel = 0; channel < channels; channel++) {
+            pcm[index * channels + channel] = static_cast<int16_t>(value);
+        }
+    }
+    return signal;
+}
+
+static void Report(const char* name, const double nsPerFrame, const size_t samplesPerFrame)
+{
+    printf("%-32s %10.1f ns/frame %10.2f Msamples/s %10.1f x real time\n", name, nsPerFrame,
+           samplesPerFrame * 1000.0 / nsPerFrame, FRAME_MS * 1000000.0 / nsPerFrame);
+}
+
+static void RunConverter(const uint32_t frames)
+{
+    static const uint32_t RATES_HZ[] = { 8000, 22050, 44100, 48000 };
+    static const uint32_t CHANNELS[] = { 1, 2, 4 };
+
+    for (uint32_t rate : RATES_HZ) {
+        for (uint32_t channels : CHANNELS) {
+            std::unique_ptr<AudioFormatConverter> converter = AudioFormatConverter::create(rate, channels, 16000);
+            if (!converter) {
+                continue;
+            }
+            const std::vector<uint8_t> signal = MakeSignal(rate, channels, frames);
+            const size_t frameBytes = signal.size() / frames;
+            std::vector<uint8_t> out;
+            out.reserve(frameBytes * 2);
+            size_t offset = 0;
+            const double ns = Bench::Measure(frames, [&]() {
+                out.clear();
+                converter->Process(&signal[offset], frameBytes, out);
+                offset = (offset + frameBytes) % signal.size();
+                Bench::sink += out.size();
+            });
+            char name[32];
+            snprintf(name, sizeof(name), "convert %u Hz x%u", rate, channels);
+            Report(name, ns, frameBytes / sizeof(int16_t));
+        }
+    }
+}
+
+/// Runs the decoder over packets, each holding one 20 ms frame
+static void RunDecoder(const char* name, AudioDecoder& decoder, const std::vector<std::vector<uint8_t>>& packets)
+{
+    std::vector<uint8_t> out;
+    size_t index = 0;
+    const double ns = Bench::Measure(static_cast<uint32_t>(packets.size()), [&]() {
+        out.clear();
+        decoder.Decode(packets[index].data(), packets[index].size(), out);
+        index = (index + 1) % packets.size();
+        Bench::sink += out.size();
+    });
+    Report(name, ns, VOICE_FRAME_SAMPLES);
+}
+
+static void RunDecoders(const uint32_t frames)
+{
+    // IMA ADPCM content does not change the decode work, random nibbles behind a valid header will do
+    std::vector<std::vector<uint8_t>> adpcm(frames, std::vector<uint8_t>(4 + VOICE_FRAME_SAMPLES / 2));
+    uint32_t seed = 1;
+    for (std::vector<uint8_t>& packet : adpcm) {
+        for (uint8_t& byte : packet) {
+            seed = seed * 1664525u + 1013904223u;
+            byte = static_cast<uint8_t>(seed >> 24);
+        }
+        packet[2] = packet[2] % 89;
+    }
+    std::unique_ptr<AudioDecoder> decoder = AudioDecoder::create(AudioDecoder::Codec::ADPCM_IMA, VOICE_RATE_HZ, 1);
+    if (decoder) {
+        RunDecoder("decode ADPCM", *decoder, adpcm);
+    }
+
+#if defined(OPUS_SUPPORT)
+    // Packets as a remote would send them, 32 kbit/s CBR
+    int error = OPUS_OK;
+    OpusEncoder* encoder = opus_encoder_create(VOICE_RATE_HZ, 1, OPUS_APPLICATION_VOIP, &error);
+    if (encoder == nullptr) {
+        fprintf(stderr, "Failed to create the Opus encoder <%s>\n", opus_strerror(error));
+        return;
+    }
+    opus_encoder_ctl(encoder, OPUS_SET_BITRATE(32000));
+    opus_encoder_ctl(encoder, OPUS_SET_VBR(0));
+    const std::vector<uint8_t> signal = MakeSignal(VOICE_RATE_HZ, 1, frames);
+    const int16_t* pcm = reinterpret_cast<const int16_t*>(signal.data());
+    std::vector<std::vector<uint8_t>> opus(frames, std::vector<uint8_t>(1275));
+    for (uint32_t index = 0; index < frames; index++) {
+        const opus_int32 bytes = opus_encode(encoder, pcm + index * VOICE_FRAME_SAMPLES, VOICE_FRAME_SAMPLES, opus[index].data(), static_cast<opus_int32>(opus[index].size()));
+        opus[index].resize(bytes > 0 ? bytes : 0);
+    }
+    opus_encoder_destroy(encoder);
+
+    decoder = AudioDecoder::create(AudioDecoder::Codec::OPUS, VOICE_RATE_HZ, 1);
+    if (decoder) {
+        RunDecoder("decode Opus", *decoder, opus);
+    }
+#endif
+}
+
+/// Upload encoder CPU per frame, and the bytes a typical utterance uploads compared with LPCM
+static void RunEncoder(const uint32_t frames)
+{
+    const std::vector<uint8_t> signal = MakeSignal(VOICE_RATE_HZ, 1, frames);
+    const size_t frameBytes = VOICE_FRAME_SAMPLES * sizeof(int16_t);
+    const size_t utteranceBytes = static_cast<size_t>(VOICE_RATE_HZ) * sizeof(int16_t) * UTTERANCE_MS / 1000;
+    printf("LPCM upload of a %u ms utterance: %zu bytes\n", UTTERANCE_MS, utteranceBytes);
+
+    static const int COMPLEXITIES[] = { 0, 4, 10 };
+    for (int complexity : COMPLEXITIES) {
+        AudioEncoder::Config config;
+        config.sampleRateHz = VOICE_RATE_HZ;
+        config.bitRate = 32000;
+        config.frameMs = FRAME_MS;
+        config.complexity = complexity;
+        std::unique_ptr<AudioEncoder> encoder = AudioEncoder::create(config);
+        if (!encoder) {
+            printf("Opus upload unavailable, no encoder rows\n");
+            return;
+        }
+
+        std::vector<uint8_t> out;
+        size_t offset = 0;
+        const double ns = Bench::Measure(frames, [&]() {
+            out.clear();
+            encoder->Encode(&signal[offset], frameBytes, out);
+            offset = (offset + frameBytes) % signal.size();
+            Bench::sink += out.size();
+        });
+        char name[32];
+        snprintf(name, sizeof(name), "encode Opus complexity %d", complexity);
+        Report(name, ns, VOICE_FRAME_SAMPLES);
+
+        encoder->Flush(out);
+        out.clear();
+        for (size_t utterance = 0; utterance < utteranceBytes; utterance += frameBytes) {
+            encoder->Encode(&signal[utterance % signal.size()], frameBytes, out);
+        }
+        encoder->Flush(out);
+        printf("%-32s %10zu bytes per utterance, %.1f%% of LPCM\n", "", out.size(), 100.0 * out.size() / utteranceBytes);
+    }
+}
+
+/// Per frame cost of the noise suppressor against its 20 ms real time budget, unbounded so it never bypasses
+static void RunNoiseSuppressor(const uint32_t frames)
+{
+    AudioNoiseSuppressor::Config config;
+    config.sampleRateHz = VOICE_RATE_HZ;
+    config.suppressionDb = 12;
+    config.budgetUs = 0;
+    std::unique_ptr<AudioNoiseSuppressor> suppressor = AudioNoiseSuppressor::create(config);
+    if (!suppressor) {
+        return;
+    }
+
+    const std::vector<uint8_t> signal = MakeSignal(VOICE_RATE_HZ, 1, frames);
+    const size_t frameBytes = VOICE_FRAME_SAMPLES * sizeof(int16_t);
+    std::vector<uint8_t> out;
+    out.reserve(frameBytes * 2);
+    size_t offset = 0;
+    const double ns = Bench::Measure(frames, [&]() {
+        out.clear();
+        suppressor->Process(&signal[offset], frameBytes, out);
+        offset = (offset + frameBytes) % signal.size();
+        Bench::sink += out.size();
+    });
+    Report("noise suppressor", ns, VOICE_FRAME_SAMPLES);
+
+    const AudioNoiseSuppressor::Stats stats = suppressor->GetStats();
+    printf("%-32s per %u ms hop: avg %u us, max %u us\n", "", stats.hopMs, stats.frameUsAvg, stats.frameUsMax);
+}
+
+int main(int argc, char* argv[])
+{
+    const uint32_t frames = Bench::Count(argc, argv, 5000);
+
+    printf("%u frames of %u ms\n", frames, FRAME_MS);
+    RunConverter(frames);
+    RunDecoders(frames);
+    RunEncoder(frames);
+    RunNoiseSuppressor(frames);
+    return 0;
+}
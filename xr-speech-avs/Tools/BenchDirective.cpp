@@ -0,0 +1,198 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Measures how fast ThunderInputManager::receive can tell a Speak directive from the rest. The old check searched the
+// whole message for the Speak namespace and name, DirectiveHeader scans the header only. The built-in corpus is a
+// Speak, a RenderTemplate and a 300 KB APL RenderDocument with the header before and after the payload; directives
+// captured from a device can be passed as files instead, one per file.
+// The delivery rows compare handing each directive to the VoiceToApps task and two JSON consumers (avs_sdt and the
+// GUI) the old way, a copy for the task and a parse per consumer, with one shared Directive parsed once. Heap
+// allocations per directive are counted apart for C++ and jansson.
+// Usage: avs-bench-directive [file...]
+
+#include "Bench.h"
+
+#include "Directive.h"
+#include "DirectiveHeader.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+using WPEFramework::DirectiveHeader;
+
+static const size_t BYTES_PER_CASE = 256 * 1024 * 1024;
+static const uint32_t JSON_CONSUMERS = 2;
+
+static uint64_t g_allocations;
+static uint64_t g_jsonAllocations;
+
+static void* JsonMalloc(size_t size)
+{
+    g_jsonAllocations++;
+    return malloc(size);
+}
+
+void* operator new(size_t size)
+{
+    g_allocations++;
+    void* memory = malloc(size != 0 ? size : 1);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+
+static std::string Header(const char* nameSpace, const char* name)
+{
+    return std::string("\"header\":{\"namespace\":\"") + nameSpace + "\",\"name\":\"" + name +
+           "\",\"messageId\":\"4f8b6e2c-1d1a-4c63-9d0e-2b7a5c3e9f10\",\"dialogRequestId\":\"9a1c2e44-77b0-4b1e-a0f3-3c2d1e0f5a66\"}";
+}
+
+static std::string Directive(const std::string& header, const std::string& payload, const bool headerFirst)
+{
+    return headerFirst ? "{\"directive\":{" + header + ",\"payload\":" + payload + "}}"
+                       : "{\"directive\":{\"payload\":" + payload + "," + header + "}}";
+}
+
+/// An APL document of about size bytes, nested components with escaped strings as real documents have
+static std::string AplPayload(const size_t size)
+{
+    std::string payload = "{\"presentationToken\":\"amzn1.as-tt.v1.ThirdPartySdkSpeechlet#TID#1\",\"document\":{\"type\":\"APL\",\"version\":\"1.4\",\"mainTemplate\":{\"items\":[";
+    for (size_t item = 0; payload.size() < size; item++) {
+        payload += (item == 0 ? "" : ",");
+        payload += "{\"type\":\"Container\",\"items\":[{\"type\":\"Text\",\"text\":\"Item " + std::to_string(item) +
+                   " \\\"quoted\\\" text with \\\\ escapes\",\"fontSize\":\"28dp\"},{\"type\":\"Image\",\"source\":\"https://example.com/" +
+                   std::to_string(item) + ".png\",\"width\":\"100vw\"}]}";
+    }
+    return payload + "]}}}";
+}
+
+static std::vector<std::pair<std::string, std::string>> BuiltInCorpus()
+{
+    std::vector<std::pair<std::string, std::string>> corpus;
+    corpus.emplace_back("Speak", Directive(Header("SpeechSynthesizer", "Speak"),
+        "{\"url\":\"cid:DeviceTTSRendererV4_3f3c1c42-2b0e-4a8f-8a4e-6f1f3b0f6a1d_1296658441\",\"format\":\"AUDIO_MPEG\",\"token\":\"amzn1.as-ct.v1.#ACRI#DeviceTTSRendererV4_3f3c1c42\",\"caption\":{\"content\":\"WEBVTT\\n\\n1\\n00:00.000 --> 00:01.500\\nIt is 72 degrees.\",\"type\":\"WEBVTT\"}}", true));
+    corpus.emplace_back("RenderTemplate", Directive(Header("TemplateRuntime", "RenderTemplate"),
+        "{\"token\":\"amzn1.as-tt.v1.Domain:Weather\",\"type\":\"WeatherTemplate\",\"title\":{\"mainTitle\":\"Seattle\",\"subTitle\":\"Today\"},\"currentWeather\":\"72\\u00b0\",\"description\":\"Sunny\"}", true));
+    corpus.emplace_back("RenderDocument head", Directive(Header("Alexa.Presentation.APL", "RenderDocument"), AplPayload(300 * 1024), true));
+    corpus.emplace_back("RenderDocument tail", Directive(Header("Alexa.Presentation.APL", "RenderDocument"), AplPayload(300 * 1024), false));
+    return corpus;
+}
+
+static void Report(const char* name, const double ns, const size_t bytes)
+{
+    printf("  %-14s %12.1f ns/msg %12.0f msg/s %10.1f MB/s\n", name, ns, 1e9 / ns, bytes * 1000.0 / ns);
+}
+
+template <typename Body>
+static void ReportDelivery(const char* name, const uint32_t iterations, Body body)
+{
+    const uint64_t allocations = g_allocations;
+    const uint64_t jsonAllocations = g_jsonAllocations;
+    body();
+    const uint64_t cppPerMessage = g_allocations - allocations;
+    const uint64_t jsonPerMessage = g_jsonAllocations - jsonAllocations;
+    const double ns = Bench::Measure(iterations, body);
+    printf("  %-14s %12.1f ns/msg %12.0f msg/s   allocations/msg %llu C++ %llu jansson\n", name, ns, 1e9 / ns,
+           static_cast<unsigned long long>(cppPerMessage), static_cast<unsigned long long>(jsonPerMessage));
+}
+
+/// Old delivery: the VoiceToApps task takes a copy and every JSON consumer parses the message itself
+static void DeliverCopies(const std::string& message)
+{
+    Bench::sink += (message.find("\"namespace\":\"SpeechSynthesizer\",\"name\":\"Speak\"", 0) != std::string::npos);
+    const std::string task(message);
+    Bench::sink += task.size();
+    for (uint32_t consumer = 0; consumer < JSON_CONSUMERS; consumer++) {
+        json_error_t error;
+        json_t* json = json_loadb(message.data(), message.size(), 0, &error);
+        Bench::sink += (json != nullptr);
+        json_decref(json);
+    }
+}
+
+/// New delivery: one Directive is built and every consumer takes a reference to it
+static void DeliverShared(const std::string& message)
+{
+    DirectiveHeader header;
+    if (!header.Parse(message.data(), message.size())) {
+        return;
+    }
+    WPEFramework::Directive* directive = WPEFramework::Directive::create(message, header);
+    directive->AddRef();
+    Bench::sink += directive->Raw().size();
+    directive->Release();
+    for (uint32_t consumer = 0; consumer < JSON_CONSUMERS; consumer++) {
+        directive->AddRef();
+        Bench::sink += (directive->Json() != nullptr);
+        directive->Release();
+    }
+    directive->Release();
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::pair<std::string, std::string>> corpus;
+    for (int index = 1; index < argc; index++) {
+        std::ifstream file(argv[index], std::ios::binary);
+        if (!file) {
+            fprintf(stderr, "Failed to open %s\n", argv[index]);
+            return 1;
+        }
+        corpus.emplace_back(argv[index], std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+    }
+    if (corpus.empty()) {
+        corpus = BuiltInCorpus();
+    }
+    json_set_alloc_funcs(JsonMalloc, free);
+
+    const std::string key = "\"namespace\":\"SpeechSynthesizer\",\"name\":\"Speak\"";
+    for (const std::pair<std::string, std::string>& entry : corpus) {
+        const std::string& message = entry.second;
+        const uint32_t iterations = static_cast<uint32_t>(BYTES_PER_CASE / message.size() + 1);
+        printf("%s, %zu bytes\n", entry.first.c_str(), message.size());
+
+        const double findNs = Bench::Measure(iterations, [&]() {
+            Bench::sink += (message.find(key, 0) != std::string::npos);
+        });
+        Report("find Speak", findNs, message.size());
+
+        const double scanNs = Bench::Measure(iterations, [&]() {
+            DirectiveHeader header;
+            Bench::sink += header.Parse(message.data(), message.size()) && header.nameSpace == "SpeechSynthesizer" && header.name == "Speak";
+        });
+        Report("header scan", scanNs, message.size());
+
+        const uint32_t deliveries = iterations / 16 + 1;
+        ReportDelivery("copy and parse", deliveries, [&]() { DeliverCopies(message); });
+        ReportDelivery("shared", deliveries, [&]() { DeliverShared(message); });
+    }
+    return 0;
+}
@@ -0,0 +1,174 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Measures the caller-side cost of handing a voice frame to the ingest path, and the end-to-end byte rate.
+// The baseline copies through a global buffer into the SDS on the calling thread, the staging path copies once into
+// AudioStagingQueue and leaves the SDS write to a writer thread. The SDS is modelled as a plain ring. The caller
+// cost of the staging path is measured with push and pop on one thread, so it holds on a single core too. The batch
+// runs compare one frame per call, as Voice_Data does, with Voice_DataV batches.
+// Usage: avs-bench-ingest [frames]
+
+#include "Bench.h"
+
+#include "AudioStagingQueue.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using WPEFramework::AudioStagingQueue;
+
+static const size_t FRAME_SIZE = 640;        // 20 ms of 16 kHz / 16-bit mono, the usual xrsr frame
+static const size_t SDS_FRAMES = 256;
+static const size_t STAGING_CAPACITY = 64;
+
+class SdsModel {
+public:
+    SdsModel() : m_buffer(FRAME_SIZE * SDS_FRAMES), m_position{ 0 } {}
+
+    void Write(const uint8_t* data, const size_t length)
+    {
+        std::memcpy(&m_buffer[m_position], data, length);
+        m_position = (m_position + FRAME_SIZE) % m_buffer.size();
+    }
+
+private:
+    std::vector<uint8_t> m_buffer;
+    size_t m_position;
+};
+
+static uint8_t g_audioBuffer[3840];
+
+static void RunBaseline(const std::vector<uint8_t>& frame, const uint32_t frames)
+{
+    SdsModel sds;
+    const double ns = Bench::Measure(frames, [&]() {
+        std::memcpy(g_audioBuffer, frame.data(), frame.size());
+        sds.Write(g_audioBuffer, frame.size());
+    });
+    Bench::Report("global buffer + SDS write", ns, FRAME_SIZE, "B");
+}
+
+static void RunStaging(const std::vector<uint8_t>& frame, const uint32_t frames)
+{
+    std::unique_ptr<AudioStagingQueue> queue = AudioStagingQueue::create(STAGING_CAPACITY);
+    if (!queue) {
+        return;
+    }
+    struct iovec vector;
+    vector.iov_base = const_cast<uint8_t*>(frame.data());
+    vector.iov_len = frame.size();
+
+    uint32_t sequenceNo = 0;
+    const double ns = Bench::Measure(frames, [&]() {
+        queue->PushV(++sequenceNo, &vector, 1);
+        queue->Pop();
+    });
+    Bench::Report("staging push + pop", ns, FRAME_SIZE, "B");
+}
+
+static void RunBatches(const std::vector<uint8_t>& frame, const uint32_t frames, const uint32_t batch)
+{
+    std::unique_ptr<AudioStagingQueue> queue = AudioStagingQueue::create(STAGING_CAPACITY);
+    if (!queue) {
+        return;
+    }
+    std::vector<struct iovec> vectors(batch);
+    for (uint32_t index = 0; index < batch; index++) {
+        vectors[index].iov_base = const_cast<uint8_t*>(frame.data());
+        vectors[index].iov_len = frame.size();
+    }
+
+    uint32_t sequenceNo = 1;
+    const double ns = Bench::Measure(frames / batch, [&]() {
+        sequenceNo += static_cast<uint32_t>(queue->PushV(sequenceNo, vectors.data(), batch));
+        for (uint32_t index = 0; index < batch; index++) {
+            queue->Pop();
+        }
+    });
+    char name[32];
+    snprintf(name, sizeof(name), "staging batch of %u", batch);
+    Bench::Report(name, ns / batch, 1, "frames");
+}
+
+static void RunStagingThreaded(const std::vector<uint8_t>& frame, const uint32_t frames)
+{
+    std::unique_ptr<AudioStagingQueue> queue = AudioStagingQueue::create(STAGING_CAPACITY);
+    if (!queue) {
+        return;
+    }
+    std::atomic<bool> done{ false };
+    std::thread writer([&]() {
+        SdsModel sds;
+        while (true) {
+            const bool last = done.load(std::memory_order_acquire);
+            const AudioStagingQueue::Frame* staged;
+            while ((staged = queue->Front()) != nullptr) {
+                sds.Write(staged->data, staged->length);
+                queue->Pop();
+            }
+            if (last) {
+                break;
+            }
+            queue->Wait(10);
+        }
+    });
+
+    struct iovec vector;
+    vector.iov_base = const_cast<uint8_t*>(frame.data());
+    vector.iov_len = frame.size();
+    uint64_t retries = 0;
+    const uint64_t start = Bench::NowNs();
+    for (uint32_t index = 0; index < frames; index++) {
+        while (queue->PushV(index + 1, &vector, 1) == 0) {
+            retries++;
+            std::this_thread::yield();
+        }
+    }
+    done.store(true, std::memory_order_release);
+    queue->Signal();
+    writer.join();
+    const uint64_t totalNs = Bench::NowNs() - start;
+
+    const AudioStagingQueue::Stats stats = queue->GetStats();
+    printf("%-32s %10.1f ns/op %12.2f MB/s end to end, %llu full retries, latency avg %u us max %u us\n",
+           "staging + writer thread", static_cast<double>(totalNs) / frames,
+           static_cast<double>(frames) * FRAME_SIZE * 1000.0 / totalNs,
+           static_cast<unsigned long long>(retries), stats.latencyUsAvg, stats.latencyUsMax);
+}
+
+int main(int argc, char* argv[])
+{
+    const uint32_t frames = Bench::Count(argc, argv, 1000000);
+    std::vector<uint8_t> frame(FRAME_SIZE);
+    for (size_t index = 0; index < frame.size(); index++) {
+        frame[index] = static_cast<uint8_t>(index * 7);
+    }
+
+    printf("%u frames of %zu bytes\n", frames, FRAME_SIZE);
+    RunBaseline(frame, frames);
+    RunStaging(frame, frames);
+    RunStagingThreaded(frame, frames);
+    for (uint32_t batch = 1; batch <= 32; batch *= 4) {
+        RunBatches(frame, frames, batch);
+    }
+    return 0;
+}
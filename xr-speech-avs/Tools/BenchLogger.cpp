@@ -0,0 +1,111 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Measures SDK log lines/s and caller-side latency with 1, 2 and 4 threads logging at once. The synchronous rows
+// format with a stringstream and call rdkx_logger on the caller, as ThunderLogger::emit used to; the async rows post
+// to AsyncLogWriter with the ring size ThunderLogger uses. Flood rows log back to back, which overruns the ring, so
+// the burst rows log 32 lines per millisecond per thread to time posts that are kept. Latency includes two steady
+// clock reads per call.
+// Results go to stderr, send stdout (the log lines themselves) to /dev/null.
+// Usage: avs-bench-logger [lines per thread] > /dev/null
+
+#include "Bench.h"
+
+#include "AsyncLogWriter.h"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using WPEFramework::AsyncLogWriter;
+
+static const size_t LOG_WRITER_ENTRIES = 256;
+static const char* TEXT = "DirectiveSequencer:onDirective:directive=SpeechSynthesizer.Speak,messageId=4f8b6e2c-1d1a-4c63-9d0e-2b7a5c3e9f10";
+
+static void LogSynchronous(const char level, const char* moniker, const char* text)
+{
+    std::stringstream ss;
+    ss << "[" << moniker << "] " << level << " " << text;
+    XLOGD_DEBUG("%s", ss.str().c_str());
+}
+
+static const uint32_t BURST_LINES = 32;
+
+/// burst 0 logs back to back, otherwise every burst lines are followed by a 1 ms pause
+template <typename Log>
+static void Run(const char* name, const uint32_t threads, const uint32_t lines, const uint32_t burst, Log log)
+{
+    std::vector<std::vector<uint32_t>> latencies(threads, std::vector<uint32_t>(lines));
+    std::vector<std::thread> workers;
+    const uint64_t start = Bench::NowNs();
+    for (uint32_t thread = 0; thread < threads; thread++) {
+        workers.emplace_back([&, thread]() {
+            char moniker[8];
+            snprintf(moniker, sizeof(moniker), "%06x", thread + 1);
+            for (uint32_t line = 0; line < lines; line++) {
+                const uint64_t before = Bench::NowNs();
+                log('9', moniker, TEXT);
+                latencies[thread][line] = static_cast<uint32_t>(Bench::NowNs() - before);
+                if (burst != 0 && (line + 1) % burst == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    const uint64_t totalNs = Bench::NowNs() - start;
+
+    std::vector<uint32_t> all;
+    all.reserve(static_cast<size_t>(threads) * lines);
+    for (const std::vector<uint32_t>& latency : latencies) {
+        all.insert(all.end(), latency.begin(), latency.end());
+    }
+    std::sort(all.begin(), all.end());
+    fprintf(stderr, "%-16s %u threads %8.2f Mlines/s  p50 %6u ns  p99 %7u ns  max %9u ns\n", name, threads,
+            static_cast<double>(all.size()) * 1000.0 / totalNs, all[all.size() / 2], all[all.size() * 99 / 100], all.back());
+}
+
+int main(int argc, char* argv[])
+{
+    const uint32_t lines = Bench::Count(argc, argv, 100000);
+    fprintf(stderr, "%u lines per thread\n", lines);
+
+    for (uint32_t burst : { 0u, BURST_LINES }) {
+        for (uint32_t threads = 1; threads <= 4; threads *= 2) {
+            Run(burst == 0 ? "sync flood" : "sync burst", threads, lines, burst, LogSynchronous);
+        }
+        for (uint32_t threads = 1; threads <= 4; threads *= 2) {
+            std::unique_ptr<AsyncLogWriter> writer = AsyncLogWriter::create(LOG_WRITER_ENTRIES);
+            if (!writer) {
+                return 1;
+            }
+            Run(burst == 0 ? "async flood" : "async burst", threads, lines, burst, [&](const char level, const char* moniker, const char* text) {
+                writer->Post(level, moniker, text);
+            });
+            const AsyncLogWriter::Stats stats = writer->GetStats();
+            fprintf(stderr, "%-16s posted %llu dropped %llu\n", "", static_cast<unsigned long long>(stats.posted), static_cast<unsigned long long>(stats.dropped));
+        }
+    }
+    return 0;
+}
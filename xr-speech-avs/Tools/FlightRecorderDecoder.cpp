@@ -0,0 +1,189 @@
+ /*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2022 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Decodes a flight recorder file written by FlightRecorder, typically <path>.prev after a crash.
+// Usage: avs-flight-decoder <file> [seconds]
+
+#include "FlightRecorderFormat.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace WPEFramework::FlightRecorderFormat;
+
+struct Event {
+    uint64_t sequence;
+    uint64_t timeNs;
+    uint16_t type;
+    uint32_t value;
+    std::string payload;
+};
+
+static const char* TypeName(const uint16_t type)
+{
+    switch (static_cast<Type>(type)) {
+    case Type::SESSION:      return "SESSION";
+    case Type::INGEST_STATS: return "INGEST";
+    case Type::DIALOG_STATE: return "DIALOG";
+    case Type::DIRECTIVE:    return "DIRECTIVE";
+    case Type::SDS_OVERRUN:  return "SDS_OVERRUN";
+    case Type::STAGING_DROP: return "STAGING_DROP";
+    case Type::ERROR:        return "ERROR";
+    }
+    return "UNKNOWN";
+}
+
+static const char* SessionName(const uint32_t value)
+{
+    static const char* names[] = { "session begin", "stream begin", "stream kwd", "stream end", "session end" };
+    return value < sizeof(names) / sizeof(names[0]) ? names[value] : "unknown";
+}
+
+static const char* DialogName(const uint32_t value)
+{
+    static const char* names[] = { "IDLE", "LISTENING", "EXPECTING", "THINKING", "SPEAKING", "FINISHED" };
+    return value < sizeof(names) / sizeof(names[0]) ? names[value] : "unknown";
+}
+
+static void PrintDetails(const Event& event)
+{
+    switch (static_cast<Type>(event.type)) {
+    case Type::SESSION:
+        printf("%s", SessionName(event.value));
+        break;
+    case Type::INGEST_STATS:
+        if (event.payload.size() == sizeof(IngestStats)) {
+            IngestStats stats;
+            memcpy(&stats, event.payload.data(), sizeof(stats));
+            printf("enqueued %llu dropped %llu committed %llu depth %u lost %u latency max %u us jitter %u ms",
+                (unsigned long long)stats.framesEnqueued, (unsigned long long)stats.framesDropped,
+                (unsigned long long)stats.framesCommitted, stats.depth, stats.framesLost, stats.latencyUsMax, stats.jitterMs);
+        }
+        break;
+    case Type::DIALOG_STATE:
+        printf("%s", DialogName(event.value));
+        break;
+    case Type::SDS_OVERRUN: {
+        uint64_t words = 0;
+        memcpy(&words, event.payload.data(), std::min(event.payload.size(), sizeof(words)));
+        printf("rc %d words %llu", static_cast<int32_t>(event.value), (unsigned long long)words);
+        break;
+    }
+    case Type::STAGING_DROP:
+        printf("frames %u", event.value);
+        break;
+    case Type::DIRECTIVE:
+    case Type::ERROR:
+        printf("%s", event.payload.c_str());
+        break;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "Usage: %s <file> [seconds]\n", argv[0]);
+        return 1;
+    }
+    const double seconds = argc == 3 ? atof(argv[2]) : 0.0;
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file) {
+        fprintf(stderr, "Failed to open %s\n", argv[1]);
+        return 1;
+    }
+    const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < sizeof(Header)) {
+        fprintf(stderr, "Truncated header\n");
+        return 1;
+    }
+    const Header* header = reinterpret_cast<const Header*>(data.data());
+    if (header->magic != MAGIC || header->version != VERSION || header->slotSize != sizeof(Slot)) {
+        fprintf(stderr, "Not a flight recorder file or unsupported version\n");
+        return 1;
+    }
+    const uint64_t slotCount = header->slotCount;
+    if (slotCount == 0 || (slotCount & (slotCount - 1)) != 0 || data.size() < sizeof(Header) + slotCount * sizeof(Slot)) {
+        fprintf(stderr, "Truncated or corrupt slot ring\n");
+        return 1;
+    }
+
+    // A slot only counts if its sequence number maps back to it, anything else was torn by the crash
+    const Slot* slots = reinterpret_cast<const Slot*>(header + 1);
+    std::vector<Event> events;
+    for (uint64_t index = 0; index < slotCount; index++) {
+        const Slot& slot = slots[index];
+        const uint64_t sequence = slot.sequence.load();
+        if (sequence == 0 || ((sequence - 1) & (slotCount - 1)) != index) {
+            continue;
+        }
+        Event event;
+        event.sequence = sequence - 1;
+        event.timeNs = slot.timeNs;
+        event.type = slot.type;
+        event.value = slot.value;
+        event.payload.assign(reinterpret_cast<const char*>(slot.payload), std::min<size_t>(slot.length, PAYLOAD_SIZE));
+        events.push_back(event);
+    }
+    std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.sequence < b.sequence; });
+
+    printf("pid %llu slots %llu written %llu valid %zu\n", (unsigned long long)header->pid, (unsigned long long)slotCount,
+        (unsigned long long)header->head.load(), events.size());
+    if (events.empty()) {
+        return 0;
+    }
+
+    uint64_t fromNs = 0;
+    if (seconds > 0.0) {
+        uint64_t lastNs = 0;
+        for (const Event& event : events) {
+            lastNs = std::max(lastNs, event.timeNs);
+        }
+        const uint64_t spanNs = static_cast<uint64_t>(seconds * 1e9);
+        fromNs = lastNs > spanNs ? lastNs - spanNs : 0;
+    }
+
+    for (const Event& event : events) {
+        if (event.timeNs < fromNs) {
+            continue;
+        }
+        // Wall clock from the anchor taken when the file was opened
+        const int64_t realtimeNs = header->realtimeNs + (static_cast<int64_t>(event.timeNs) - header->monotonicNs);
+        const time_t realtimeS = static_cast<time_t>(realtimeNs / 1000000000LL);
+        struct tm local;
+        char stamp[32];
+        localtime_r(&realtimeS, &local);
+        strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &local);
+
+        printf("%s.%06lld %8llu %-12s ", stamp, (long long)(realtimeNs % 1000000000LL) / 1000,
+            (unsigned long long)event.sequence, TypeName(event.type));
+        PrintDetails(event);
+        printf("\n");
+    }
+    return 0;
+}
@@ -41,11 +41,10 @@
 
 #define AVS_SDT_IDENTIFIER (0xC11FB9C2)
 
-uint8_t audio_buffer[3840];
-
 avs_sdt_obj_t *avs_obj;
 
 static bool     avs_sdt_object_is_valid(avs_sdt_obj_t *obj);
+static void     avs_sdt_msg_release_directive(void *release_data);
 
 static void avs_sdt_handler_session_begin(void *data, const uuid_t uuid, xrsr_src_t src, uint32_t dst_index, xrsr_keyword_detector_result_t *detector_result, xrsr_session_config_out_t *config_out, xrsr_session_config_in_t *config_in, rdkx_timestamp_t *timestamp, const char *transcription_in);
 static void avs_sdt_handler_session_end(void *data, const uuid_t uuid, xrsr_session_stats_t *stats, rdkx_timestamp_t *timestamp);
@@ -55,6 +54,15 @@ static void avs_sdt_handler_stream_end(void *data, const uuid_t uuid, xrsr_strea
 static void avs_sdt_handler_connected(void *data, const uuid_t uuid, xrsr_handler_send_t send, void *param, rdkx_timestamp_t *timestamp);
 static void avs_sdt_handler_disconnected(void *data, const uuid_t uuid, xrsr_session_end_reason_t reason, bool retry, bool *detect_resume, rdkx_timestamp_t *timestamp);
 static int avs_recv_audiodata(unsigned char* frame,uint32_t sample_qty);
+static void avs_sdt_voice_eos(void *user_data);
+
+// rdkx timestamps are CLOCK_MONOTONIC, the same clock the ingest pipeline stamps its audio with
+static uint64_t avs_sdt_timestamp_ns(const rdkx_timestamp_t *timestamp) {
+   if(timestamp == NULL) {
+      return(0);
+   }
+   return((uint64_t)timestamp->tv_sec * 1000000000ULL + (uint64_t)timestamp->tv_nsec);
+}
 
 bool avs_sdt_object_is_valid(avs_sdt_obj_t *obj) {
    if(obj != NULL && obj->identifier == AVS_SDT_IDENTIFIER) {
@@ -85,7 +93,15 @@ avs_sdt_object_t avs_sdt_create(const avs_sdt_params_t *params)
   return(avs_obj) ;
 }
 
+uint32_t avs_sdt_version(void) {
+   return((AVS_SDT_VERSION_MAJOR << 16) | AVS_SDT_VERSION_MINOR);
+}
+
 bool avs_sdt_handlers(avs_sdt_object_t object, const avs_sdt_handlers_t *handlers_in, xrsr_handlers_t *handlers_out) {
+   return(avs_sdt_handlers_sized(object, handlers_in, AVS_SDT_HANDLERS_SIZE_V1, handlers_out));
+}
+
+bool avs_sdt_handlers_sized(avs_sdt_object_t object, const avs_sdt_handlers_t *handlers_in, size_t handlers_size, xrsr_handlers_t *handlers_out) {
   
    XLOGD_DEBUG(" Set avs sdt handlers ");
   
@@ -94,6 +110,10 @@ bool avs_sdt_handlers(avs_sdt_object_t object, const avs_sdt_handlers_t *handler
       XLOGD_ERROR("invalid object");
       return(false);
    }
+   if(handlers_in == NULL || handlers_size < AVS_SDT_HANDLERS_SIZE_V1) {
+      XLOGD_ERROR("invalid handlers size <%zu>", handlers_size);
+      return(false);
+   }
    bool ret = true;
    handlers_out->data          = obj;
    //handlers_out->session_begin = (xrsr_handler_session_begin_t)avs_sdt_handler_session_begin;
@@ -107,18 +127,37 @@ bool avs_sdt_handlers(avs_sdt_object_t object, const avs_sdt_handlers_t *handler
    handlers_out->disconnected  = avs_sdt_handler_disconnected;
    handlers_out->stream_audio  = avs_recv_audiodata;
 
-   obj->handlers = *handlers_in;
+   // Callers built against an older header pass a smaller structure, the handlers it does not have stay NULL
+   memset(&obj->handlers, 0, sizeof(obj->handlers));
+   memcpy(&obj->handlers, handlers_in, handlers_size < sizeof(obj->handlers) ? handlers_size : sizeof(obj->handlers));
+
+   Voice_SetEndOfSpeechHandler(avs_sdt_voice_eos, obj);
 
    return(ret);
 }
 
 int avs_recv_audiodata(unsigned char* data, uint32_t size)
 {
-  uint16_t length = size;
-  XLOGD_DEBUG("Received Buffer Size:%d",size);
-  memcpy(audio_buffer,data,size);
+  // The xrsr frame is handed straight to the shared data stream writer which performs the only copy
+  if(data == NULL || size == 0) {
+     XLOGD_ERROR("invalid frame");
+     return(-1);
+  }
+  // xrsr delivers the frames of a stream in order, number them so the ingest pipeline tracks the session.
+  // Sequence number 0 is reserved for unsequenced sources.
+  uint32_t seq = 0;
+  if(avs_sdt_object_is_valid(avs_obj)) {
+     if(++avs_obj->audio_seq == 0) {
+        avs_obj->audio_seq = 1;
+     }
+     seq = avs_obj->audio_seq;
+  }
+  struct iovec frame;
+  frame.iov_base = data;
+  frame.iov_len  = size;
   /***AVS DATA***/
-  Voice_Data(0,audio_buffer,length);
+  Voice_DataV(seq, &frame, 1);
+  return(0);
 }
 
 bool avs_sdt_update_mask_pii(avs_sdt_object_t object, bool enable) {
@@ -141,6 +180,7 @@ void avs_sdt_destroy(avs_sdt_object_t object) {
       return;
    }
    XLOGD_INFO("");
+   Voice_SetEndOfSpeechHandler(NULL, NULL);
    obj->identifier                     = 0;
    free(obj);
    
@@ -159,6 +199,9 @@ void avs_sdt_handler_session_begin(void *data, const uuid_t uuid, xrsr_src_t src
 
    char uuid_str[37] = {'\0'};
    int rc = 0;
+   uuid_copy(obj->uuid, uuid);
+   uuid_unparse_lower(uuid, uuid_str);
+   Voice_TraceEvent(VOICE_TRACE_SESSION_BEGIN, uuid_str, avs_sdt_timestamp_ns(timestamp));
    avs_sdt_stream_params_t stream_params;
    stream_params.keyword_sample_begin               = (detector_result != NULL ? detector_result->offset_kwd_begin - detector_result->offset_buf_begin : 0);
    stream_params.keyword_sample_end                 = (detector_result != NULL ? detector_result->offset_kwd_end   - detector_result->offset_buf_begin : 0);
@@ -173,10 +216,25 @@ void avs_sdt_handler_session_begin(void *data, const uuid_t uuid, xrsr_src_t src
    stream_params.nonlinear_confidence               = 0;
    stream_params.signal_noise_ratio                 = 255.0; // Invalid;
    stream_params.push_to_talk                       = false;
+   stream_params.audio_codec                        = AVS_SDT_AUDIO_CODEC_PCM_16;
 
    if(obj->handlers.session_begin != NULL) {
       (*obj->handlers.session_begin)(uuid, src, dst_index, config_out, &stream_params, timestamp,obj->user_data);
    }
+
+   // Compressed frames are decoded inside the ingest pipeline, the codec applies from the stream begin
+   switch(stream_params.audio_codec) {
+      case AVS_SDT_AUDIO_CODEC_ADPCM_IMA: Voice_SetInputCodec(VOICE_CODEC_ADPCM_IMA); break;
+      case AVS_SDT_AUDIO_CODEC_OPUS:      Voice_SetInputCodec(VOICE_CODEC_OPUS);      break;
+      default:                            Voice_SetInputCodec(VOICE_CODEC_PCM_16);    break;
+   }
+
+   // A detected keyword opens a wake word recognize, the pre-roll and keyword stay in the upload for cloud verification
+   if(detector_result != NULL && !stream_params.push_to_talk) {
+      Voice_SetKeyword(stream_params.keyword_sample_begin, stream_params.keyword_sample_end);
+   } else {
+      Voice_SetKeyword(0, 0);
+   }
    
 
 }
@@ -190,6 +248,8 @@ void avs_sdt_handler_session_end(void *data, const uuid_t uuid, xrsr_session_sta
       XLOGD_ERROR("invalid object");
       return;
    }
+   Voice_TraceEvent(VOICE_TRACE_SESSION_END, NULL, avs_sdt_timestamp_ns(timestamp));
+
    if(obj->handlers.session_end != NULL) {
       (*obj->handlers.session_end)(uuid, stats, timestamp,obj->user_data);
    }
@@ -208,10 +268,17 @@ void avs_sdt_handler_stream_begin(void *data, const uuid_t uuid, xrsr_src_t src,
       return;
    }
 
+   obj->audio_seq = 0;
+
    if(obj->handlers.stream_begin != NULL) {
       (*obj->handlers.stream_begin)(uuid, src, timestamp, obj->user_data);
    }
    
+   if(timestamp != NULL) {
+      Voice_SetStreamBeginTime(avs_sdt_timestamp_ns(timestamp));
+   }
+   Voice_TraceEvent(VOICE_TRACE_STREAM_BEGIN, NULL, avs_sdt_timestamp_ns(timestamp));
+
    /***AVS VOICE START***/
    Voice_Start();
 }
@@ -226,6 +293,8 @@ void avs_sdt_handler_stream_kwd(void *data, const uuid_t uuid, rdkx_timestamp_t
       return;
    }
 
+   Voice_TraceEvent(VOICE_TRACE_STREAM_KWD, NULL, avs_sdt_timestamp_ns(timestamp));
+
    if(obj->handlers.stream_kwd != NULL) {
       (*obj->handlers.stream_kwd)(uuid, timestamp,obj->user_data);
    }
@@ -241,12 +310,47 @@ void avs_sdt_handler_stream_end(void *data, const uuid_t uuid, xrsr_stream_stats
       return;
    }
 
+   Voice_TraceEvent(VOICE_TRACE_STREAM_END, NULL, avs_sdt_timestamp_ns(timestamp));
+
    if(obj->handlers.stream_end != NULL) {
       (*obj->handlers.stream_end)(uuid, stats, timestamp, obj->user_data);
    }
    
    /***AVS VOICE STOP***/
     Voice_Stop();
+
+   // The stream has been flushed through the ingest pipeline, the session levels are final
+   voice_level_stats_t level_stats;
+   if(Voice_GetLevelStats(&level_stats)) {
+      avs_sdt_stream_levels_t levels;
+      levels.frames        = level_stats.session_frames;
+      levels.rms_dbfs_min  = level_stats.session_rms_dbfs_min;
+      levels.rms_dbfs_mean = level_stats.session_rms_dbfs_mean;
+      levels.rms_dbfs_max  = level_stats.session_rms_dbfs_max;
+      levels.peak_dbfs     = level_stats.session_peak_dbfs;
+      levels.clips         = level_stats.session_clips;
+
+      XLOGD_INFO("levels frames <%llu> rms min <%.1f> mean <%.1f> max <%.1f> peak <%.1f> dBFS clips <%llu>", (unsigned long long)levels.frames, levels.rms_dbfs_min, levels.rms_dbfs_mean, levels.rms_dbfs_max, levels.peak_dbfs, (unsigned long long)levels.clips);
+
+      if(obj->handlers.stream_levels != NULL) {
+         (*obj->handlers.stream_levels)(uuid, &levels, obj->user_data);
+      }
+   }
+}
+
+void avs_sdt_voice_eos(void *user_data) {
+
+   XLOGD_DEBUG(" EOS avs sdt stream .....");
+
+   avs_sdt_obj_t *obj = (avs_sdt_obj_t *)user_data;
+   if(!avs_sdt_object_is_valid(obj)) {
+      XLOGD_ERROR("invalid object");
+      return;
+   }
+
+   if(obj->handlers.stream_eos != NULL) {
+      (*obj->handlers.stream_eos)(obj->uuid, obj->user_data);
+   }
 }
 
 void avs_sdt_handler_connected(void *data, const uuid_t uuid, xrsr_handler_send_t send, void *param, rdkx_timestamp_t *timestamp) {
@@ -287,7 +391,126 @@ void avs_server_msg(const char *message, unsigned long length){
       return;
    }
    
-   if(avs_obj->handlers.msg != NULL) {   
+   if(avs_obj->handlers.message != NULL) {
+      // The caller's buffer is only borrowed, the handler gets its own copy it can keep
+      char *copy = (char *)malloc(length + 1);
+      if(copy == NULL) {
+         XLOGD_ERROR("out of memory");
+         return;
+      }
+      memcpy(copy, message, length);
+      copy[length] = '\0';
+      avs_sdt_msg_t *msg = avs_sdt_msg_create(copy, length, free, copy);
+      if(msg == NULL) {
+         free(copy);
+         return;
+      }
+      avs_obj->handlers.message(msg, avs_obj->user_data);
+   } else if(avs_obj->handlers.msg != NULL) {   
 		avs_obj->handlers.msg(message, length, avs_obj->user_data);
    }
 }
+
+void avs_server_directive(avs_sdt_directive_t *directive) {
+
+   if(!avs_sdt_object_is_valid(avs_obj)) {
+      XLOGD_ERROR("invalid object");
+      return;
+   }
+
+   if(avs_obj->handlers.directive != NULL) {
+      avs_obj->handlers.directive(directive, avs_obj->user_data);
+   } else if(avs_obj->handlers.message != NULL) {
+      // The message keeps the directive alive instead of copying its bytes
+      unsigned long length = 0;
+      const char *data     = avs_sdt_directive_raw(directive, &length);
+      avs_sdt_msg_t *msg   = avs_sdt_msg_create(data, length, avs_sdt_msg_release_directive, avs_sdt_directive_ref(directive));
+      if(msg == NULL) {
+         avs_sdt_directive_unref(directive);
+         return;
+      }
+      avs_obj->handlers.message(msg, avs_obj->user_data);
+   } else if(avs_obj->handlers.msg != NULL) {
+      unsigned long length = 0;
+      const char *message  = avs_sdt_directive_raw(directive, &length);
+      avs_obj->handlers.msg(message, length, avs_obj->user_data);
+   }
+}
+
+struct avs_sdt_msg {
+   uint32_t              references;
+   const char *          data;
+   unsigned long         length;
+   avs_sdt_msg_release_t release;
+   void *                release_data;
+};
+
+static void avs_sdt_msg_release_directive(void *release_data) {
+   avs_sdt_directive_unref((avs_sdt_directive_t *)release_data);
+}
+
+avs_sdt_msg_t *avs_sdt_msg_create(const char *data, unsigned long length, avs_sdt_msg_release_t release, void *release_data) {
+   if(data == NULL) {
+      XLOGD_ERROR("invalid params");
+      return(NULL);
+   }
+   avs_sdt_msg_t *message = (avs_sdt_msg_t *)malloc(sizeof(avs_sdt_msg_t));
+   if(message == NULL) {
+      XLOGD_ERROR("out of memory");
+      return(NULL);
+   }
+   message->references   = 1;
+   message->data         = data;
+   message->length       = length;
+   message->release      = release;
+   message->release_data = release_data;
+   return(message);
+}
+
+avs_sdt_msg_t *avs_sdt_msg_ref(avs_sdt_msg_t *message) {
+   if(message != NULL) {
+      __atomic_fetch_add(&message->references, 1, __ATOMIC_RELAXED);
+   }
+   return(message);
+}
+
+void avs_sdt_msg_unref(avs_sdt_msg_t *message) {
+   if(message == NULL) {
+      return;
+   }
+   if(__atomic_fetch_sub(&message->references, 1, __ATOMIC_ACQ_REL) != 1) {
+      return;
+   }
+   if(message->release != NULL) {
+      message->release(message->release_data);
+   }
+   free(message);
+}
+
+const char *avs_sdt_msg_data(const avs_sdt_msg_t *message, unsigned long *length) {
+   if(length != NULL) {
+      *length = message->length;
+   }
+   return(message->data);
+}
+
+void avs_server_message(avs_sdt_msg_t *message) {
+
+   if(message == NULL) {
+      return;
+   }
+   if(!avs_sdt_object_is_valid(avs_obj)) {
+      XLOGD_ERROR("invalid object");
+      avs_sdt_msg_unref(message);
+      return;
+   }
+
+   if(avs_obj->handlers.message != NULL) {
+      avs_obj->handlers.message(message, avs_obj->user_data);
+      return;
+   }
+   if(avs_obj->handlers.msg != NULL) {
+      avs_obj->handlers.msg(message->data, message->length, avs_obj->user_data);
+   }
+   avs_sdt_msg_unref(message);
+}
@@ -23,6 +23,7 @@
 #ifndef __AVS_SDT_SUPPORT__
 #define __AVS_SDT_SUPPORT__
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <xrsr.h>
@@ -33,12 +34,22 @@
 #define AVS_SDT_SESSION_ID_LEN_MAX      (64)  ///< Session identifier maximum length including NULL termination
 #define AVS_SDT_SESSION_STR_LEN_MAX     (512) ///< Session strings maximum length including NULL termination
 
+#define AVS_SDT_VERSION_MAJOR           (2)   ///< Bumped when the handler structure grew past msg (sized registration)
+#define AVS_SDT_VERSION_MINOR           (0)
+
 typedef struct {
    bool        test_flag;        ///< True if the device is used for testing only, otherwise false
    bool        mask_pii;         ///< True if the PII must be masked from the log
    void       *user_data;        ///< User data that is passed in to all of the callbacks
 } avs_sdt_params_t;
 
+/// Codec of the audio frames delivered through the stream_audio handler
+typedef enum {
+   AVS_SDT_AUDIO_CODEC_PCM_16    = 0, ///< 16-bit little endian PCM
+   AVS_SDT_AUDIO_CODEC_ADPCM_IMA = 1, ///< IMA ADPCM blocks (int16 predictor, uint8 step index, uint8 reserved, 4-bit samples)
+   AVS_SDT_AUDIO_CODEC_OPUS      = 2  ///< One Opus packet per frame
+} avs_sdt_audio_codec_t;
+
 /// AVS stream parameter structure
 /// The stream parameter data structure is returned in the session begin callback function.
 typedef struct {
@@ -55,11 +66,30 @@ typedef struct {
    double   linear_confidence;                  ///<
    int32_t  nonlinear_confidence;               ///<
    bool     push_to_talk;                       ///< True if the session was started by the user pressing a button
+   avs_sdt_audio_codec_t audio_codec;           ///< Codec of the session audio frames, may be updated by the session begin handler
 } avs_sdt_stream_params_t;
 
+/// Input levels of a stream in dB relative to full scale
+typedef struct {
+   uint64_t frames;                             ///< Frames received in the stream
+   float    rms_dbfs_min;                       ///< Quietest frame
+   float    rms_dbfs_mean;                      ///< RMS over the whole stream
+   float    rms_dbfs_max;                       ///< Loudest frame
+   float    peak_dbfs;                          ///< Peak sample
+   uint64_t clips;                              ///< Full scale samples
+} avs_sdt_stream_levels_t;
+
 //sdt object
 typedef void * avs_sdt_object_t;
 
+// A server directive parsed once and shared between consumers, reference counted
+typedef struct avs_sdt_directive avs_sdt_directive_t;
+
+// A server message buffer, reference counted. The release callback frees the bytes once the last reference is dropped
+typedef struct avs_sdt_msg avs_sdt_msg_t;
+
+typedef void (*avs_sdt_msg_release_t)(void *release_data);
+
 //sdt session begin handler
 typedef void (*avs_sdt_handler_session_begin_t)(const uuid_t uuid, xrsr_src_t src, uint32_t dst_index, xrsr_session_config_out_t *configuration, avs_sdt_stream_params_t *stream_params, rdkx_timestamp_t *timestamp, void *user_data);
 
@@ -72,9 +102,15 @@ typedef void (*avs_sdt_handler_stream_begin_t)(const uuid_t uuid, xrsr_src_t src
 //sdt kwd handler
 typedef void (*avs_sdt_handler_stream_kwd_t)(const uuid_t uuid, rdkx_timestamp_t *timestamp, void *user_data); 
 
+//sdt stream end of speech handler
+typedef void (*avs_sdt_handler_stream_eos_t)(const uuid_t uuid, void *user_data);
+
 //sdt stream end handler
 typedef void (*avs_sdt_handler_stream_end_t)(const uuid_t uuid, xrsr_stream_stats_t *stats, rdkx_timestamp_t *timestamp, void *user_data);
 
+//sdt stream levels handler
+typedef void (*avs_sdt_handler_stream_levels_t)(const uuid_t uuid, const avs_sdt_stream_levels_t *levels, void *user_data);
+
 //sdt stream connect handler
 typedef void (*avs_sdt_handler_connected_t)(const uuid_t uuid, rdkx_timestamp_t *timestamp, void *user_data);
 
@@ -84,7 +120,14 @@ typedef void (*avs_sdt_handler_disconnected_t)(const uuid_t uuid, bool retry, rd
 //sdt dserver msg handler
 typedef void (*avs_sdt_handler_msg_t)(const char *msg, unsigned long length, void *user_data);
 
-//sdt handler structure
+//sdt server message handler, takes over one reference to the message and must unref it when done, on any thread
+typedef void (*avs_sdt_handler_message_t)(avs_sdt_msg_t *message, void *user_data);
+
+//sdt server directive handler, the directive is borrowed for the call, take a reference to keep it
+typedef void (*avs_sdt_handler_directive_t)(avs_sdt_directive_t *directive, void *user_data);
+
+//sdt handler structure, zero it (memset or = {0}) before filling it in, a handler that is not NULL is called.
+//Handlers are appended only, register with avs_sdt_handlers_sized so the library reads no more than the caller has.
 typedef struct {
    avs_sdt_handler_session_begin_t     session_begin;     ///< Indicates that a voice session has started
    avs_sdt_handler_session_end_t       session_end;       ///< Indicates that a voice session has ended
@@ -94,20 +137,55 @@ typedef struct {
    avs_sdt_handler_connected_t         connected;         ///< The session has connected
    avs_sdt_handler_disconnected_t      disconnected;      ///< The session has disconnected
    avs_sdt_handler_msg_t               msg;               ///< Raw messages from the server
+   avs_sdt_handler_stream_eos_t        stream_eos;        ///< The local end-pointer detected the end of speech in the stream
+   avs_sdt_handler_stream_levels_t     stream_levels;     ///< Input levels of the stream, reported after the stream end
+   avs_sdt_handler_directive_t         directive;         ///< Parsed server directives, message or msg is called with the raw bytes when not set
+   avs_sdt_handler_message_t           message;           ///< Server messages handed over without a copy, takes precedence over msg
 } avs_sdt_handlers_t;
 
+// Size of the handler structure of version 1, up to and including msg
+#define AVS_SDT_HANDLERS_SIZE_V1        (offsetof(avs_sdt_handlers_t, stream_eos))
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 avs_sdt_object_t avs_sdt_create(const avs_sdt_params_t *params);
 
+// Version 1 registration, reads the handlers up to msg only, stream_eos and later stay unset
 bool avs_sdt_handlers(avs_sdt_object_t object, const avs_sdt_handlers_t *handlers_in, xrsr_handlers_t *handlers_out);
 
+// handlers_size is sizeof(avs_sdt_handlers_t) as the caller was built, handlers past it stay unset
+bool avs_sdt_handlers_sized(avs_sdt_object_t object, const avs_sdt_handlers_t *handlers_in, size_t handlers_size, xrsr_handlers_t *handlers_out);
+
+// Returns (AVS_SDT_VERSION_MAJOR << 16) | AVS_SDT_VERSION_MINOR of the library
+uint32_t avs_sdt_version(void);
+
 void avs_sdt_destroy(avs_sdt_object_t object);
 
 void avs_server_msg(const char *message, unsigned long length);
 
+void avs_server_directive(avs_sdt_directive_t *directive);
+
+// Hands the caller's reference to the message handler, the caller must not touch the message afterwards
+void avs_server_message(avs_sdt_msg_t *message);
+
+avs_sdt_msg_t *avs_sdt_msg_create(const char *data, unsigned long length, avs_sdt_msg_release_t release, void *release_data);
+avs_sdt_msg_t *avs_sdt_msg_ref(avs_sdt_msg_t *message);
+void        avs_sdt_msg_unref(avs_sdt_msg_t *message);
+const char *avs_sdt_msg_data(const avs_sdt_msg_t *message, unsigned long *length);
+
+avs_sdt_directive_t *avs_sdt_directive_ref(avs_sdt_directive_t *directive);
+void        avs_sdt_directive_unref(avs_sdt_directive_t *directive);
+const char *avs_sdt_directive_raw(avs_sdt_directive_t *directive, unsigned long *length);
+const char *avs_sdt_directive_namespace(avs_sdt_directive_t *directive);
+const char *avs_sdt_directive_name(avs_sdt_directive_t *directive);
+const char *avs_sdt_directive_message_id(avs_sdt_directive_t *directive);
+const char *avs_sdt_directive_dialog_request_id(avs_sdt_directive_t *directive);
+// Parsed on first call and owned by the directive, valid while the caller holds a directive reference. Other
+// consumers read the same object concurrently so it must not be modified, use json_deep_copy for a modifiable copy.
+const json_t *avs_sdt_directive_json(avs_sdt_directive_t *directive);
+
 bool avs_sdt_update_mask_pii(avs_sdt_object_t object, bool enable);
 
 #ifdef __cplusplus
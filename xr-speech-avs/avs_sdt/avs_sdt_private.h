@@ -34,6 +34,8 @@ typedef struct {
    void *                      param;
    bool                        mask_pii;
    void *                      user_data;
+   uint32_t                    audio_seq;
+   uuid_t                      uuid;
 } avs_sdt_obj_t;
 
 
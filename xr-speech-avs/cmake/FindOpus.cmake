@@ -0,0 +1,56 @@
+# If not stated otherwise in this file or this component's license file the
+# following copyright and licenses apply:
+#
+# Copyright 2022 RDK Management
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# - Try to find opus.
+# Once done, this will define
+#
+#  OPUS_FOUND - the opus codec library is available
+#  OPUS_INCLUDES - The opus include directories
+#  OPUS_LIBRARIES - The libraries needed to use opus
+#  Opus::Opus - The opus library and all its dependecies
+#
+find_package(PkgConfig)
+pkg_check_modules(PC_OPUS opus)
+
+include(FindPackageHandleStandardArgs)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(PC_OPUS DEFAULT_MSG PC_OPUS_FOUND)
+
+mark_as_advanced(PC_OPUS_INCLUDE_DIRS PC_OPUS_LIBRARIES PC_OPUS_LIBRARY_DIRS)
+
+if(${PC_OPUS_FOUND})
+    find_library(OPUS_LIBRARY opus
+        HINTS ${PC_OPUS_LIBRARY_DIRS}
+    )
+
+    set(OPUS_LIBRARIES ${PC_OPUS_LIBRARIES})
+    set(OPUS_INCLUDES ${PC_OPUS_INCLUDE_DIRS})
+    set(OPUS_FOUND ${PC_OPUS_FOUND})
+
+    if(NOT TARGET Opus::Opus)
+        add_library(Opus::Opus UNKNOWN IMPORTED)
+
+        set_target_properties(Opus::Opus
+                PROPERTIES
+                IMPORTED_LINK_INTERFACE_LANGUAGES "C"
+                IMPORTED_LOCATION "${OPUS_LIBRARY}"
+                INTERFACE_COMPILE_OPTIONS "${PC_OPUS_CFLAGS_OTHER}"
+                INTERFACE_INCLUDE_DIRECTORIES "${PC_OPUS_INCLUDE_DIRS}"
+                INTERFACE_LINK_LIBRARIES "${PC_OPUS_LIBRARIES}"
+                )
+    endif()
+endif()